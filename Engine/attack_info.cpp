@@ -0,0 +1,152 @@
+#include "attack_info.h"
+
+#include <array>
+
+namespace
+{
+    // Squares strictly between two squares on a rank, file or diagonal;
+    // empty for squares that aren't aligned
+    constexpr std::array<std::array<uint64_t, 64>, 64> makeBetween()
+    {
+        std::array<std::array<uint64_t, 64>, 64> between{};
+        constexpr int DIRECTIONS[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+        for (int from = 0; from < 64; ++from)
+        {
+            for (const auto &direction : DIRECTIONS)
+            {
+                uint64_t ray = 0;
+                int file = (from & 7) + direction[0], rank = (from >> 3) + direction[1];
+                for (; file >= 0 && file < 8 && rank >= 0 && rank < 8; file += direction[0], rank += direction[1])
+                {
+                    between[from][rank * 8 + file] = ray;
+                    ray |= 1ULL << (rank * 8 + file);
+                }
+            }
+        }
+        return between;
+    }
+
+    constexpr auto BETWEEN = makeBetween();
+
+    Bitboard between(Square a, Square b)
+    {
+        return Bitboard(BETWEEN[a.index()][b.index()]);
+    }
+
+    // Pieces standing alone between the king of color and an enemy slider
+    Bitboard sliderBlockers(const Board &board, Color color)
+    {
+        Square king_sq = board.kingSq(color);
+        Bitboard queens = board.pieces(PieceType::QUEEN, ~color);
+        Bitboard snipers = (chess::attacks::rook(king_sq, Bitboard(0)) & (board.pieces(PieceType::ROOK, ~color) | queens)) |
+                           (chess::attacks::bishop(king_sq, Bitboard(0)) & (board.pieces(PieceType::BISHOP, ~color) | queens));
+
+        Bitboard blockers(0);
+        while (snipers)
+        {
+            Square sniper = snipers.pop();
+            Bitboard in_between = between(king_sq, sniper) & board.occ();
+            if (in_between.count() == 1)
+            {
+                blockers |= in_between;
+            }
+        }
+        return blockers;
+    }
+}
+
+void AttackInfo::init(const Board &board)
+{
+    Color us = board.sideToMove();
+    checkers = chess::attacks::attackers(board, ~us, board.kingSq(us));
+    has_attacks = false;
+}
+
+void AttackInfo::computeCheckInfo(const Board &board)
+{
+    Color us = board.sideToMove();
+    Square their_king = board.kingSq(~us);
+    Bitboard occupied = board.occ();
+
+    blockers[0] = sliderBlockers(board, Color::WHITE);
+    blockers[1] = sliderBlockers(board, Color::BLACK);
+
+    check_squares[static_cast<int>(PieceType::PAWN)] = chess::attacks::pawn(~us, their_king);
+    check_squares[static_cast<int>(PieceType::KNIGHT)] = chess::attacks::knight(their_king);
+    check_squares[static_cast<int>(PieceType::BISHOP)] = chess::attacks::bishop(their_king, occupied);
+    check_squares[static_cast<int>(PieceType::ROOK)] = chess::attacks::rook(their_king, occupied);
+    check_squares[static_cast<int>(PieceType::QUEEN)] = check_squares[static_cast<int>(PieceType::BISHOP)] |
+                                                        check_squares[static_cast<int>(PieceType::ROOK)];
+    check_squares[static_cast<int>(PieceType::KING)] = Bitboard(0);
+}
+
+void AttackInfo::computeAttacks(const Board &board)
+{
+    Bitboard occupied = board.occ();
+
+    for (Color color : {Color::WHITE, Color::BLACK})
+    {
+        // Pawns all at once; only the pieces get a map of their own
+        Bitboard pawns = board.pieces(PieceType::PAWN, color);
+        Bitboard all = color == Color::WHITE
+                           ? chess::attacks::pawnLeftAttacks<Color::WHITE>(pawns) | chess::attacks::pawnRightAttacks<Color::WHITE>(pawns)
+                           : chess::attacks::pawnLeftAttacks<Color::BLACK>(pawns) | chess::attacks::pawnRightAttacks<Color::BLACK>(pawns);
+
+        for (PieceType piece_type : {PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN, PieceType::KING})
+        {
+            Bitboard pieces = board.pieces(piece_type, color);
+            while (pieces)
+            {
+                Square sq = pieces.pop();
+                Bitboard attacks(0);
+                switch (static_cast<int>(piece_type))
+                {
+                case static_cast<int>(PieceType::KNIGHT):
+                    attacks = chess::attacks::knight(sq);
+                    break;
+                case static_cast<int>(PieceType::BISHOP):
+                    attacks = chess::attacks::bishop(sq, occupied);
+                    break;
+                case static_cast<int>(PieceType::ROOK):
+                    attacks = chess::attacks::rook(sq, occupied);
+                    break;
+                case static_cast<int>(PieceType::QUEEN):
+                    attacks = chess::attacks::queen(sq, occupied);
+                    break;
+                default:
+                    attacks = chess::attacks::king(sq);
+                    break;
+                }
+                piece_attacks[sq.index()] = attacks;
+                all |= attacks;
+            }
+        }
+        attacked[static_cast<int>(color)] = all;
+    }
+
+    has_attacks = true;
+}
+
+bool AttackInfo::givesCheck(const Board &board, const Move &move) const
+{
+    // Castling, en passant and promotions change the board around more
+    // than one square; they are rare enough to leave to chess.hpp
+    if (move.typeOf() != Move::NORMAL)
+    {
+        return board.givesCheck(move) != chess::CheckType::NO_CHECK;
+    }
+
+    Square from = move.from();
+    Square to = move.to();
+
+    // Direct check
+    if (check_squares[static_cast<int>(board.at(from).type())].check(to.index()))
+    {
+        return true;
+    }
+
+    // Discovered check: a blocker of their king leaves the line to it
+    Square their_king = board.kingSq(~board.sideToMove());
+    return blockers[static_cast<int>(~board.sideToMove())].check(from.index()) &&
+           !between(their_king, to).check(from.index()) && !between(their_king, from).check(to.index());
+}
@@ -0,0 +1,40 @@
+#ifndef ATTACK_INFO_H
+#define ATTACK_INFO_H
+
+#include "types.h"
+
+// Attack maps of one position, built once per node and shared by the search
+// (check detection, givesCheck) and the evaluation (mobility, king safety).
+// init() only finds the checkers and is done for every node; the rest is
+// filled in on demand, by computeCheckInfo() before a move loop and by
+// computeAttacks() when the evaluation asks for the attack maps.
+struct AttackInfo {
+    // Set by init
+    Bitboard checkers;  // Pieces giving check to the side to move
+
+    // Set by computeCheckInfo
+    Bitboard blockers[2];       // [king color] sole blockers, of either color, between the king and an enemy slider
+    Bitboard check_squares[6];  // [piece type] squares from which a piece of the side to move checks the enemy king
+
+    // Set by computeAttacks
+    bool has_attacks = false;
+    Bitboard piece_attacks[64];  // [square] squares attacked by the piece there, pawns excepted
+    Bitboard attacked[2];        // [color] squares attacked by any piece
+
+    void init(const Board& board);
+    void computeCheckInfo(const Board& board);
+    void computeAttacks(const Board& board);
+
+    bool inCheck() const { return static_cast<bool>(checkers); }
+
+    // Pieces of color that may only move along the line to their king
+    Bitboard pinned(const Board& board, Color color) const {
+        return blockers[static_cast<int>(color)] & board.us(color);
+    }
+
+    // Same answer as board.givesCheck(move) != NO_CHECK, from the check
+    // info; move must be legal for the side to move
+    bool givesCheck(const Board& board, const Move& move) const;
+};
+
+#endif // ATTACK_INFO_H
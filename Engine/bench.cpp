@@ -0,0 +1,121 @@
+#include "bench.h"
+#include "perft.h"
+#include <iostream>
+#include <chrono>
+
+namespace
+{
+    struct BenchPosition
+    {
+        const char *fen;
+        int perft_depth;
+        uint64_t perft_nodes;
+    };
+
+    // Standard perft suite with reference counts
+    const BenchPosition BENCH_POSITIONS[] = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 6, 119060324ULL},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 5, 193690690ULL},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083ULL},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292ULL},
+        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 5, 89941194ULL},
+        {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 5, 164075551ULL},
+    };
+
+    int64_t elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    }
+
+    uint64_t nps(uint64_t nodes, int64_t ms)
+    {
+        return nodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(1, ms));
+    }
+}
+
+int runBench(ChessEngine &engine, int search_depth)
+{
+    uint64_t perft_nodes = 0, search_nodes = 0;
+    int64_t perft_ms = 0, search_ms = 0;
+    int failures = 0;
+    int index = 0;
+    SearchStats stats;
+
+    for (const auto &position : BENCH_POSITIONS)
+    {
+        ++index;
+        std::cerr << "Position " << index << ": " << position.fen << std::endl;
+
+        // Move generation
+        Board board(position.fen);
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = perft(board, position.perft_depth);
+        int64_t ms = elapsedMs(start);
+
+        perft_nodes += nodes;
+        perft_ms += ms;
+
+        std::cerr << "  perft " << position.perft_depth << ": " << nodes
+                  << " nodes " << ms << " ms " << nps(nodes, ms) << " nps";
+        if (nodes != position.perft_nodes)
+        {
+            std::cerr << " FAILED (expected " << position.perft_nodes << ")";
+            ++failures;
+        }
+        std::cerr << std::endl;
+
+        // Fixed-depth search from a cold table
+        engine.newGame();
+        engine.setPosition(position.fen, {});
+        start = std::chrono::steady_clock::now();
+        SearchLimits limits;
+        limits.depth = search_depth;
+        engine.search(limits);
+        ms = elapsedMs(start);
+        nodes = engine.totalNodes();
+
+        search_nodes += nodes;
+        search_ms += ms;
+        stats.merge(engine.searchStats());
+
+        std::cerr << "  search depth " << search_depth << ": " << nodes
+                  << " nodes " << ms << " ms " << nps(nodes, ms) << " nps" << std::endl;
+    }
+
+    std::cerr << "===========================" << std::endl
+              << "Perft nodes    : " << perft_nodes << std::endl
+              << "Perft time (ms): " << perft_ms << std::endl
+              << "Perft nps      : " << nps(perft_nodes, perft_ms) << std::endl
+              << "Search nodes   : " << search_nodes << std::endl
+              << "Search time(ms): " << search_ms << std::endl
+              << "Search nps     : " << nps(search_nodes, search_ms) << std::endl;
+
+    if (SEARCH_STATS_ENABLED)
+    {
+        stats.print(std::cerr, "  ");
+    }
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " perft position(s) FAILED" << std::endl;
+    }
+
+    // Machine-readable summary on stdout; the report above goes to stderr
+    std::cout << "{\"depth\":" << search_depth
+              << ",\"perft_nodes\":" << perft_nodes
+              << ",\"perft_ms\":" << perft_ms
+              << ",\"search_nodes\":" << search_nodes
+              << ",\"search_ms\":" << search_ms
+              << ",\"search_nps\":" << nps(search_nodes, search_ms)
+              << ",\"perft_failures\":" << failures;
+    if (SEARCH_STATS_ENABLED)
+    {
+        std::cout << ",\"stats\":";
+        stats.printJson(std::cout);
+    }
+    std::cout << "}" << std::endl;
+
+    return failures > 0 ? 1 : 0;
+}
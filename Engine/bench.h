@@ -0,0 +1,11 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "engine.h"
+
+// Fixed benchmark: verified perft counts plus a fixed-depth search over a
+// set of positions, reporting nodes, time and NPS. Returns non-zero if any
+// perft count differs from the reference value.
+int runBench(ChessEngine& engine, int search_depth = 7);
+
+#endif // BENCH_H
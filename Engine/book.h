@@ -7,7 +7,10 @@
 #include <fstream>
 #include <map>
 
-// PolyGlot book entry structure
+// Size of one on-disk PolyGlot record (big-endian key, move, weight, learn)
+constexpr size_t POLYGLOT_ENTRY_SIZE = 16;
+
+// Decoded PolyGlot book entry
 struct PolyGlotEntry {
     uint64_t key;      // Position hash
     uint16_t move;     // Move in PolyGlot format
@@ -17,35 +20,53 @@ struct PolyGlotEntry {
     PolyGlotEntry() : key(0), move(0), weight(0), learn(0) {}
 };
 
+// The book file stays in its on-disk big-endian form: memory-mapped where
+// available (falling back to a single bulk read) and binary-searched in place.
+// PolyGlot books are sorted by key, so loading does no parsing or sorting.
 class OpeningBook {
 public:
     OpeningBook();
     ~OpeningBook();
     
     bool loadFromFile(const std::string& filename);
+    void unload();
     Move getMove(const Board& board);
     bool isLoaded() const { return loaded_; }
+    bool isMapped() const { return mapped_ != nullptr; }
     
     // Statistics
-    size_t size() const { return entries_.size(); }
+    size_t size() const { return entry_count_; }
     int getTotalWeight(uint64_t key) const;
     
 private:
-    std::vector<PolyGlotEntry> entries_;
+    const unsigned char* data_;        // Raw records (mapped or buffer_)
+    size_t entry_count_;
+    void* mapped_;                     // mmap base, nullptr when not mapped
+    size_t mapped_size_;
+    std::vector<unsigned char> buffer_;
     bool loaded_;
     
-    // PolyGlot key generation
+    // Record accessors, decoding big-endian fields in place
+    uint64_t keyAt(size_t index) const;
+    PolyGlotEntry entryAt(size_t index) const;
+    
+    bool mapFile(const std::string& filename);
+    bool readFile(const std::string& filename);
+    
+    // PolyGlot key generation: the board's own hash, with the from-scratch
+    // computation kept as a reference
     uint64_t getPolyGlotKey(const Board& board);
+    static uint64_t computePolyGlotKey(const Board& board);
     
     // PolyGlot move conversion
     Move polyGlotMoveToMove(uint16_t poly_move, const Board& board);
     uint16_t moveToPolyGlotMove(const Move& move);
     
-    // Binary search for book entries
-    std::vector<PolyGlotEntry> findEntries(uint64_t key);
+    // Binary search: [first, last) record indices matching key
+    std::pair<size_t, size_t> findEntries(uint64_t key) const;
     
     // Random move selection based on weights
-    Move selectMove(const std::vector<PolyGlotEntry>& entries, const Board& board);
+    Move selectMove(size_t first, size_t last, const Board& board);
 };
 
-#endif // BOOK_H
\ No newline at end of file
+#endif // BOOK_H
@@ -0,0 +1,368 @@
+#include "datagen.h"
+#include "search.h"
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void writeVarint(std::string &out, uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            out += static_cast<char>(value | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    uint32_t zigzag(int value)
+    {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    int unzigzag(uint32_t value)
+    {
+        return static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1);
+    }
+
+    // One finished game in the packed format
+    class GameRecord
+    {
+    public:
+        explicit GameRecord(const Board &start) : fen_(start.getFen()) {}
+
+        void addPly(uint8_t move_index, int score)
+        {
+            plies_ += static_cast<char>(move_index);
+            writeVarint(plies_, zigzag(score + last_score_));
+            last_score_ = score;
+            ++count_;
+        }
+
+        uint32_t size() const { return count_; }
+
+        // result: 0 black wins, 1 draw, 2 white wins
+        std::string serialize(uint8_t result) const
+        {
+            std::string out;
+            out += static_cast<char>(fen_.size());
+            out += fen_;
+            out += static_cast<char>(result);
+            writeVarint(out, count_);
+            out += plies_;
+            return out;
+        }
+
+    private:
+        std::string fen_;
+        std::string plies_;
+        uint32_t count_ = 0;
+        int last_score_ = 0;
+    };
+
+    struct DatagenShared
+    {
+        std::ofstream out;
+        std::mutex mutex;
+        std::atomic<uint64_t> positions{0};
+        uint64_t target = 0;
+        uint64_t games = 0;
+        uint64_t bytes = 0;
+        uint64_t results[3] = {0, 0, 0};  // Black wins, draws, white wins
+        int nodes = 0;
+        int depth = 0;
+        TimePoint start;
+    };
+
+    int moveIndex(const chess::Movelist &moves, Move move)
+    {
+        for (int i = 0; i < static_cast<int>(moves.size()); ++i)
+        {
+            if (moves[i] == move)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Deepest completed iteration within the node and depth budget
+    SearchResult searchPosition(Search &search, TranspositionTable &tt, const Board &board, int nodes, int depth)
+    {
+        SearchInfo info;
+        info.reset();
+        info.node_limit = static_cast<uint64_t>(std::max(0, nodes));
+        tt.newSearch();
+
+        SearchResult best{Move::NO_MOVE, 0, 0, PVLine{}};
+        for (int d = 1; d <= (depth > 0 ? depth : MAX_DEPTH); ++d)
+        {
+            auto iteration = search.searchRoot(board, d, info);
+            // A cut-short first iteration still beats having no move
+            if (info.should_stop() && best.best_move != Move::NO_MOVE)
+            {
+                break;
+            }
+            best = iteration;
+            if (info.should_stop())
+            {
+                break;
+            }
+        }
+        return best;
+    }
+
+    // Plays a few random moves from the start position; false if the
+    // result is over or badly unbalanced
+    bool randomOpening(Search &search, TranspositionTable &tt, Board &board, std::mt19937_64 &rng,
+                       const DatagenShared &shared)
+    {
+        board.setFen(chess::constants::STARTPOS);
+        for (int i = 0; i < DATAGEN_RANDOM_PLIES; ++i)
+        {
+            chess::Movelist moves;
+            chess::movegen::legalmoves(moves, board);
+            if (moves.empty())
+            {
+                return false;
+            }
+            board.makeMove(moves[std::uniform_int_distribution<int>(0, moves.size() - 1)(rng)]);
+        }
+
+        if (board.isGameOver().second != chess::GameResult::NONE)
+        {
+            return false;
+        }
+        SearchResult check = searchPosition(search, tt, board, shared.nodes, shared.depth);
+        return check.best_move != Move::NO_MOVE && std::abs(check.score) <= DATAGEN_OPENING_MAX_SCORE;
+    }
+
+    void datagenThread(DatagenShared &shared, uint64_t seed)
+    {
+        TranspositionTable tt(DATAGEN_HASH_MB);
+        Evaluation evaluation;
+        auto search = std::make_unique<Search>(tt, evaluation);
+        std::mt19937_64 rng(seed);
+
+        while (shared.positions.load(std::memory_order_relaxed) < shared.target)
+        {
+            tt.clear();
+            search->clearHistory();
+
+            Board board;
+            if (!randomOpening(*search, tt, board, rng, shared))
+            {
+                continue;
+            }
+
+            GameRecord record(board);
+            int white_result = 1;  // 0 black wins, 1 draw, 2 white wins
+            int win_plies = 0, draw_plies = 0;
+
+            for (int ply = 0; ply < DATAGEN_MAX_PLIES; ++ply)
+            {
+                auto [reason, game_result] = board.isGameOver();
+                if (game_result != chess::GameResult::NONE)
+                {
+                    // A decided game is always lost by the side to move
+                    if (reason == chess::GameResultReason::CHECKMATE)
+                    {
+                        white_result = board.sideToMove() == Color::WHITE ? 0 : 2;
+                    }
+                    break;
+                }
+
+                SearchResult result = searchPosition(*search, tt, board, shared.nodes, shared.depth);
+                chess::Movelist moves;
+                chess::movegen::legalmoves(moves, board);
+                int index = moveIndex(moves, result.best_move);
+                if (index < 0)
+                {
+                    break;
+                }
+                record.addPly(static_cast<uint8_t>(index), result.score);
+
+                int white_score = board.sideToMove() == Color::WHITE ? result.score : -result.score;
+                win_plies = std::abs(white_score) >= DATAGEN_WIN_SCORE ? win_plies + 1 : 0;
+                draw_plies = (ply >= DATAGEN_DRAW_MIN_PLY && std::abs(white_score) <= DATAGEN_DRAW_SCORE) ? draw_plies + 1 : 0;
+                if (win_plies >= DATAGEN_WIN_PLIES)
+                {
+                    white_result = white_score > 0 ? 2 : 0;
+                    break;
+                }
+                if (draw_plies >= DATAGEN_DRAW_PLIES)
+                {
+                    break;
+                }
+
+                board.makeMove(result.best_move);
+            }
+
+            if (record.size() == 0)
+            {
+                continue;
+            }
+
+            std::string data = record.serialize(static_cast<uint8_t>(white_result));
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.out.write(data.data(), static_cast<std::streamsize>(data.size()));
+            shared.bytes += data.size();
+            ++shared.results[white_result];
+            uint64_t positions = shared.positions.fetch_add(record.size()) + record.size();
+
+            if (++shared.games % 100 == 0)
+            {
+                int64_t ms = std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - shared.start).count();
+                std::cerr << shared.games << " games, " << positions << " positions, "
+                          << (positions * 1000 / static_cast<uint64_t>(std::max<int64_t>(1, ms))) << " positions/s" << std::endl;
+                shared.out.flush();
+            }
+        }
+    }
+}
+
+PackedGameReader::PackedGameReader(std::istream &in) : in_(in), valid_(false)
+{
+    char magic[4];
+    char version = 0;
+    valid_ = in_.read(magic, 4) && std::memcmp(magic, PACKED_MAGIC, 4) == 0 &&
+             in_.get(version) && static_cast<uint8_t>(version) == PACKED_VERSION;
+}
+
+bool PackedGameReader::readVarint(uint32_t &value)
+{
+    value = 0;
+    char c;
+    for (int shift = 0; shift < 35 && in_.get(c); shift += 7)
+    {
+        value |= static_cast<uint32_t>(c & 0x7F) << shift;
+        if (!(c & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PackedGameReader::readGame()
+{
+    char length, result;
+    if (!in_.get(length))
+    {
+        return false;
+    }
+
+    std::string fen(static_cast<uint8_t>(length), '\0');
+    if (!in_.read(&fen[0], static_cast<std::streamsize>(fen.size())) || !in_.get(result) ||
+        !readVarint(remaining_) || !board_.setFen(fen))
+    {
+        return false;
+    }
+
+    result_ = static_cast<uint8_t>(result) / 2.0f;
+    last_score_ = 0;
+    return true;
+}
+
+bool PackedGameReader::next(Board &board, Move &move, int &score, float &result)
+{
+    while (remaining_ == 0)
+    {
+        if (!valid_ || !readGame())
+        {
+            return false;
+        }
+    }
+
+    char index;
+    uint32_t packed_score;
+    if (!in_.get(index) || !readVarint(packed_score))
+    {
+        return false;
+    }
+
+    chess::Movelist moves;
+    chess::movegen::legalmoves(moves, board_);
+    if (static_cast<uint8_t>(index) >= moves.size())
+    {
+        return false;
+    }
+
+    board = board_;
+    move = moves[static_cast<uint8_t>(index)];
+    score = unzigzag(packed_score) - last_score_;
+    result = result_;
+
+    last_score_ = score;
+    board_.makeMove(move);
+    --remaining_;
+    return true;
+}
+
+bool isPackedFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return PackedGameReader(file).isValid();
+}
+
+int runDatagen(const std::string &output, uint64_t positions, int threads, int nodes, int depth)
+{
+    if (threads <= 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (nodes <= 0 && depth <= 0)
+    {
+        nodes = DATAGEN_DEFAULT_NODES;
+    }
+
+    DatagenShared shared;
+    shared.out.open(output, std::ios::binary | std::ios::trunc);
+    if (!shared.out.is_open())
+    {
+        std::cerr << "Could not write " << output << std::endl;
+        return 1;
+    }
+    shared.out.write(PACKED_MAGIC, 4);
+    shared.out.put(static_cast<char>(PACKED_VERSION));
+    shared.target = positions;
+    shared.nodes = nodes;
+    shared.depth = depth;
+    shared.start = std::chrono::steady_clock::now();
+
+    std::cerr << "Generating " << positions << " positions into " << output << " with "
+              << threads << " thread(s), " << nodes << " nodes / depth " << depth << " per move" << std::endl;
+
+    std::random_device device;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i)
+    {
+        uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device() ^ static_cast<uint64_t>(i);
+        workers.emplace_back(datagenThread, std::ref(shared), seed);
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    shared.out.flush();
+
+    int64_t wall_ms = std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - shared.start).count();
+    uint64_t total = shared.positions.load();
+    std::cerr << "===========================" << std::endl
+              << "Games          : " << shared.games << " (+" << shared.results[2] << " =" << shared.results[1]
+              << " -" << shared.results[0] << ")" << std::endl
+              << "Positions      : " << total << std::endl
+              << "Bytes/position : " << std::fixed << std::setprecision(2)
+              << (total > 0 ? static_cast<double>(shared.bytes) / total : 0.0) << std::endl
+              << "Wall time (ms) : " << wall_ms << std::endl
+              << "Positions/hour : " << (total * 3600000 / static_cast<uint64_t>(std::max<int64_t>(1, wall_ms))) << std::endl;
+
+    return shared.out ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#ifndef DATAGEN_H
+#define DATAGEN_H
+
+#include "types.h"
+#include <istream>
+#include <string>
+
+// Self-play settings; every thread plays its own games with a private
+// Search and a small transposition table
+constexpr int DATAGEN_HASH_MB = 8;
+constexpr uint64_t DATAGEN_DEFAULT_POSITIONS = 1000000;
+constexpr int DATAGEN_DEFAULT_NODES = 5000;
+constexpr int DATAGEN_RANDOM_PLIES = 8;          // Random moves before the engine takes over
+constexpr int DATAGEN_OPENING_MAX_SCORE = 300;   // Openings scored beyond this are discarded
+constexpr int DATAGEN_MAX_PLIES = 400;           // Longer games are adjudicated drawn
+// Adjudication: a win once the score stays beyond WIN_SCORE for WIN_PLIES
+// plies, a draw once it stays within DRAW_SCORE for DRAW_PLIES plies after
+// DRAW_MIN_PLY
+constexpr int DATAGEN_WIN_SCORE = 1500;
+constexpr int DATAGEN_WIN_PLIES = 4;
+constexpr int DATAGEN_DRAW_SCORE = 10;
+constexpr int DATAGEN_DRAW_PLIES = 10;
+constexpr int DATAGEN_DRAW_MIN_PLY = 60;
+
+// Packed game format: a game is its start position and the chain of moves
+// played from it, so a position costs two or three bytes.
+//   file: "CEPG", u8 version
+//   game: u8 length + start FEN, u8 result (0 black wins, 1 draw, 2 white wins),
+//         varint ply count, then per ply the u8 index of the move played in
+//         chess.hpp's legal move order and varint zigzag(score + last score)
+// Scores are the search score for the side to move; consecutive scores
+// nearly cancel, which keeps the varints to a byte.
+constexpr char PACKED_MAGIC[4] = {'C', 'E', 'P', 'G'};
+constexpr uint8_t PACKED_VERSION = 1;
+
+// Streams the positions of a packed file back, in game order
+class PackedGameReader {
+public:
+    explicit PackedGameReader(std::istream& in);
+
+    // False if the stream doesn't start with a packed header
+    bool isValid() const { return valid_; }
+
+    // Next position, the move played from it, the search score for the side
+    // to move and the game result from white's point of view (1, 0.5, 0)
+    bool next(Board& board, Move& move, int& score, float& result);
+
+private:
+    std::istream& in_;
+    bool valid_;
+    Board board_;
+    uint32_t remaining_ = 0;  // Plies left in the current game
+    float result_ = 0.5f;
+    int last_score_ = 0;
+
+    bool readGame();
+    bool readVarint(uint32_t& value);
+};
+
+// True if path starts with the packed header
+bool isPackedFile(const std::string& path);
+
+// Plays engine-vs-engine games until positions positions are written to
+// output. Each move is searched to nodes nodes and/or depth plies (0 = no
+// limit on that axis). Returns non-zero if output can't be written.
+int runDatagen(const std::string& output, uint64_t positions = DATAGEN_DEFAULT_POSITIONS,
+               int threads = 0, int nodes = DATAGEN_DEFAULT_NODES, int depth = 0);
+
+#endif // DATAGEN_H
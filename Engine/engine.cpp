@@ -1,107 +1,164 @@
 #include "engine.h"
+#include "movepick.h"
+#include "uci_output.h"
 #include <iostream>
 #include <sstream>
 
-ChessEngine::ChessEngine()
+ChessEngine::ChessEngine(std::shared_ptr<TranspositionTable> shared_tt)
     : board_(chess::constants::STARTPOS),
+      tt_(std::move(shared_tt)),
       hash_size_mb_(DEFAULT_HASH_SIZE_MB),
       threads_(1),
+      move_overhead_(DEFAULT_MOVE_OVERHEAD_MS),
+      multi_pv_(1),
       searching_(false)
 {
+    shared_tt_ = tt_ != nullptr;
     initializeComponents();
 }
 
 ChessEngine::~ChessEngine()
 {
+    // Let a running search wind down before its state is destroyed
     stopSearch();
+    waitForSearch();
 }
 
 void ChessEngine::initializeComponents()
 {
-    tt_ = std::make_unique<TranspositionTable>(hash_size_mb_);
-    evaluation_ = std::make_unique<Evaluation>();
-    search_ = std::make_unique<Search>(*tt_, *evaluation_);
-    book_ = std::make_unique<OpeningBook>();
-
-    if (!book_path_.empty())
+    if (!tt_)
     {
-        book_->loadFromFile(book_path_);
+        tt_ = std::make_shared<TranspositionTable>(hash_size_mb_, clearThreads());
     }
+    evaluation_ = std::make_unique<Evaluation>();
+    search_ = std::make_unique<Search>(*tt_, *evaluation_);
+    tablebase_ = SharedResources::tablebase("");
+    search_->setTablebase(tablebase_.get());
+    search_->setRootMoveCallback([this](int depth, Move move, int number)
+                                 { reportCurrentMove(depth, move, number); });
+    resizeHelpers();
 }
 
 void ChessEngine::newGame()
 {
+    waitForSearch();
     board_.setFen(chess::constants::STARTPOS);
-    tt_->clear();
+    position_fen_.clear();
+    position_moves_.clear();
+    tt_clear_pending_ = !shared_tt_;  // Done at the next isready or go
+    search_->clearHistory();
+    for (auto &helper : helpers_)
+    {
+        helper->search->clearHistory();
+    }
     search_info_.reset();
 }
 
 void ChessEngine::setPosition(const std::string &fen, const std::vector<std::string> &moves)
 {
-    if (fen.empty() || fen == "startpos")
+    // The search reads board_; never change it under a running search
+    waitForSearch();
+
+    std::string start = (fen.empty() || fen == "startpos") ? std::string(chess::constants::STARTPOS) : fen;
+
+    // GUIs resend the whole game every move: when the new list only extends
+    // the one already on the board, play just the added moves
+    size_t applied = 0;
+    if (start == position_fen_ && moves.size() >= position_moves_.size() &&
+        std::equal(position_moves_.begin(), position_moves_.end(), moves.begin()))
     {
-        board_.setFen(chess::constants::STARTPOS);
+        applied = position_moves_.size();
     }
     else
     {
-        board_.setFen(fen);
+        board_.setFen(start);
+        position_fen_ = start;
+        position_moves_.clear();
     }
 
-    // Apply moves
-    for (const auto &moveStr : moves)
+    for (size_t i = applied; i < moves.size(); ++i)
     {
-        chess::Movelist legal_moves;
-        chess::movegen::legalmoves(legal_moves, board_);
-
-        bool move_found = false;
-        for (const auto &move : legal_moves)
+        Move move = parseMove(moves[i]);
+        if (move == Move::NO_MOVE)
         {
-            std::string move_string = static_cast<std::string>(move.from()) +
-                                      static_cast<std::string>(move.to());
+            std::cerr << "Invalid move: " << moves[i] << std::endl;
+            break;
+        }
+        board_.makeMove(move);
+        position_moves_.push_back(moves[i]);
+    }
+}
 
-            // Handle promotion
-            if (move.typeOf() == Move::PROMOTION)
-            {
-                char promo_char;
-                switch (static_cast<int>(move.promotionType()))
-                {
-                case static_cast<int>(PieceType::QUEEN):
-                    promo_char = 'q';
-                    break;
-                case static_cast<int>(PieceType::ROOK):
-                    promo_char = 'r';
-                    break;
-                case static_cast<int>(PieceType::BISHOP):
-                    promo_char = 'b';
-                    break;
-                case static_cast<int>(PieceType::KNIGHT):
-                    promo_char = 'n';
-                    break;
-                default:
-                    promo_char = 'q';
-                    break;
-                }
-                move_string += promo_char;
-            }
+Move ChessEngine::parseMove(const std::string &uci) const
+{
+    Move move;
+    try
+    {
+        move = chess::uci::uciToMove(board_, uci);
+    }
+    catch (const std::exception &)
+    {
+        return Move::NO_MOVE;
+    }
 
-            if (move_string == moveStr)
-            {
-                board_.makeMove(move);
-                move_found = true;
-                break;
-            }
-        }
+    // uciToMove only decodes; check the move is legal here
+    return move != Move::NO_MOVE && MovePicker::isLegal(board_, move) ? move : Move(Move::NO_MOVE);
+}
 
-        if (!move_found)
-        {
-            std::cerr << "Invalid move: " << moveStr << std::endl;
-            break;
-        }
+void ChessEngine::startSearch(const SearchLimits &limits, BestMoveCallback on_bestmove)
+{
+    waitForSearch();
+    prepareSearch(limits);
+
+    main_worker_.run([this, limits, on_bestmove]()
+                     {
+        Move best_move = think(limits);
+        on_bestmove(best_move, ponder_move_); });
+}
+
+Move ChessEngine::search(const SearchLimits &limits)
+{
+    waitForSearch();
+    prepareSearch(limits);
+    return think(limits);
+}
+
+void ChessEngine::waitForSearch()
+{
+    main_worker_.wait();
+}
+
+void ChessEngine::prepareSearch(const SearchLimits &limits)
+{
+    // Runs on the caller's thread, so a stop or ponderhit sent right after
+    // go always applies to this search
+    search_info_.reset();
+    last_info_depth_ = 0;
+    last_info_time_ = last_status_time_ = search_info_.start_time;
+    applyPendingChanges();
+    tt_->newSearch();
+    search_->clearStats();
+    for (auto &helper : helpers_)
+    {
+        helper->search->clearStats();
     }
+    pondering_ = limits.ponder;
+    ponder_offset_ms_ = 0;
+    ponder_move_ = Move::NO_MOVE;
+    best_score_ = 0;
+    search_info_.node_limit = limits.nodes;
+
+    // Soft limit is checked between iterations, hard limit inside the search.
+    // While pondering neither applies; ponderHit() arms them.
+    bool white = board_.sideToMove() == Color::WHITE;
+    time_manager_.init(white ? limits.wtime : limits.btime, white ? limits.winc : limits.binc,
+                       limits.movestogo, limits.movetime, limits.infinite, move_overhead_);
+    search_info_.time_limit = pondering_ ? 0 : time_manager_.hardLimit();
+
+    searching_ = true;
 }
 
-Move ChessEngine::search(int depth, int movetime, int wtime, int btime,
-                         int winc, int binc, bool infinite)
+Move ChessEngine::think(const SearchLimits &limits)
 {
     // Check opening book first
     if (book_ && book_->isLoaded())
@@ -109,81 +166,102 @@ Move ChessEngine::search(int depth, int movetime, int wtime, int btime,
         auto book_move = book_->getMove(board_);
         if (book_move != Move::NO_MOVE)
         {
+            waitWhilePondering();
+            searching_ = false;
             return book_move;
         }
     }
 
-    search_info_.reset();
-
-    // Calculate time limit
-    if (movetime > 0)
+    // go searchmoves, and in a tablebase position only the moves that keep
+    // the result (among the searchmoves, if any of them do)
+    std::vector<Move> root_moves = limits.searchmoves;
+    std::vector<Move> tb_moves;
+    if (tablebase_->probeRoot(board_, tb_moves))
     {
-        search_info_.time_limit = Duration(movetime);
+        search_info_.tbhits++;
+
+        std::vector<Move> kept;
+        for (const auto &move : tb_moves)
+        {
+            if (root_moves.empty() || std::find(root_moves.begin(), root_moves.end(), move) != root_moves.end())
+            {
+                kept.push_back(move);
+            }
+        }
+        if (!kept.empty())
+        {
+            root_moves = kept;
+        }
     }
-    else if (!infinite && (wtime > 0 || btime > 0))
+    search_->initRootMoves(board_, root_moves);
+    for (auto &helper : helpers_)
     {
-        int our_time = (board_.sideToMove() == Color::WHITE) ? wtime : btime;
-        int our_inc = (board_.sideToMove() == Color::WHITE) ? winc : binc;
-
-        // Simple time management: use 1/30 of remaining time + increment
-        int time_to_use = our_time / 30 + our_inc / 2;
-        search_info_.time_limit = Duration(std::max(100, time_to_use));
+        helper->search->initRootMoves(board_, root_moves);
     }
 
-    searching_ = true;
-
     // Perform iterative deepening search
     Move best_move = Move::NO_MOVE;
-    int max_depth = (depth > 0) ? depth : MAX_DEPTH;
+    int best_score = -MATE_VALUE;
+    PVLine best_pv;
+    int max_depth = (limits.depth > 0) ? limits.depth : MAX_DEPTH;
+    int lines = std::max(1, std::min(multi_pv_, static_cast<int>(search_->rootMoves().size())));
+    std::vector<SearchResult> line_results(lines);
+
+    startHelpers(max_depth);
 
     for (int d = 1; d <= max_depth && !search_info_.should_stop(); ++d)
     {
-        auto result = search_->searchRoot(board_, d, search_info_);
+        auto iteration_start = std::chrono::steady_clock::now();
+        search_->newIteration();
 
-        if (!search_info_.should_stop())
+        // MultiPV: line k searches all moves but the k-1 best ones
+        int completed_lines = 0;
+        for (int k = 0; k < lines && !search_info_.should_stop(); ++k)
         {
-            best_move = result.best_move;
-            search_info_.depth = d;
-
-            // Print search info
-            auto elapsed = std::chrono::duration_cast<Duration>(
-                std::chrono::steady_clock::now() - search_info_.start_time);
-
-            std::cout << "info depth " << d
-                      << " score cp " << result.score
-                      << " nodes " << result.nodes
-                      << " time " << elapsed.count()
-                      << " pv";
+            int prev_score = k < static_cast<int>(search_->rootMoves().size())
+                                 ? search_->rootMoves()[k].previous_score
+                                 : best_score;
+            line_results[k] = aspirationSearch(*search_, search_info_, d, k, prev_score, lines == 1);
+            if (!search_info_.should_stop())
+            {
+                completed_lines = k + 1;
+            }
+        }
+        const SearchResult &result = line_results[0];
 
-            for (int i = 0; i < result.pv.count; ++i)
+        if (completed_lines == 0)
+        {
+            // Keep a partial iteration only if it improved on the last one
+            if (result.best_move != Move::NO_MOVE &&
+                (best_move == Move::NO_MOVE || result.best_move == best_move || result.score > best_score))
             {
-                std::cout << " " << static_cast<std::string>(result.pv.moves[i].from())
-                          << static_cast<std::string>(result.pv.moves[i].to());
-                if (result.pv.moves[i].typeOf() == Move::PROMOTION)
-                {
-                    char promo_char;
-                    switch (static_cast<int>(result.pv.moves[i].promotionType()))
-                    {
-                    case static_cast<int>(PieceType::QUEEN):
-                        promo_char = 'q';
-                        break;
-                    case static_cast<int>(PieceType::ROOK):
-                        promo_char = 'r';
-                        break;
-                    case static_cast<int>(PieceType::BISHOP):
-                        promo_char = 'b';
-                        break;
-                    case static_cast<int>(PieceType::KNIGHT):
-                        promo_char = 'n';
-                        break;
-                    default:
-                        promo_char = 'q';
-                        break;
-                    }
-                    std::cout << promo_char;
-                }
+                best_move = result.best_move;
+                best_score = result.score;
+                best_pv = result.pv;
             }
-            std::cout << std::endl;
+            break;
+        }
+
+        best_move = result.best_move;
+        best_score = result.score;
+        best_pv = result.pv;
+        search_info_.depth = d;
+        time_manager_.update(d, best_move, best_score);
+
+        for (int k = 0; k < completed_lines; ++k)
+        {
+            reportIteration(d, k, line_results[k], "");
+        }
+
+        if (search_info_.should_stop())
+        {
+            break;
+        }
+
+        // On the opponent's clock: keep deepening until ponderhit or stop
+        if (pondering_)
+        {
+            continue;
         }
 
         // Stop if we found a mate
@@ -191,52 +269,475 @@ Move ChessEngine::search(int depth, int movetime, int wtime, int btime,
         {
             break;
         }
+
+        auto now = std::chrono::steady_clock::now();
+        int elapsed_ms = static_cast<int>(std::chrono::duration_cast<Duration>(now - search_info_.start_time).count() -
+                                          ponder_offset_ms_);
+        int iteration_ms = static_cast<int>(std::chrono::duration_cast<Duration>(now - iteration_start).count());
+        if (!time_manager_.shouldStartIteration(elapsed_ms, iteration_ms))
+        {
+            break;
+        }
     }
 
+    // bestmove must not be sent before ponderhit or stop
+    waitWhilePondering();
+
+    stopHelpers();
+
+    // Prefer a helper that completed a deeper iteration than the main thread
+    int best_depth = search_info_.depth;
+    for (const auto &helper : helpers_)
+    {
+        if (helper->result.best_move == Move::NO_MOVE)
+        {
+            continue;
+        }
+
+        if (helper->completed_depth > best_depth ||
+            (helper->completed_depth == best_depth && helper->result.score > best_score))
+        {
+            best_depth = helper->completed_depth;
+            best_score = helper->result.score;
+            best_move = helper->result.best_move;
+            best_pv = helper->result.pv;
+        }
+    }
+
+    ponder_move_ = findPonderMove(best_move, best_pv);
+    best_score_ = best_score;
+
     searching_ = false;
     return best_move;
 }
 
+void ChessEngine::ponderHit()
+{
+    if (!pondering_)
+    {
+        return;
+    }
+
+    // The opponent played the expected move: our clock runs from now on, so
+    // shift both limits by the time already spent pondering
+    int64_t elapsed = std::chrono::duration_cast<Duration>(
+        std::chrono::steady_clock::now() - search_info_.start_time).count();
+    ponder_offset_ms_ = elapsed;
+
+    int hard_limit = time_manager_.hardLimit();
+    search_info_.time_limit = hard_limit > 0 ? elapsed + hard_limit : 0;
+    pondering_ = false;
+}
+
+void ChessEngine::waitWhilePondering()
+{
+    while (pondering_ && !search_info_.should_stop())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    pondering_ = false;
+}
+
+Move ChessEngine::findPonderMove(Move best_move, const PVLine &pv)
+{
+    if (best_move == Move::NO_MOVE)
+    {
+        return Move::NO_MOVE;
+    }
+
+    if (pv.count >= 2 && pv.moves[0] == best_move)
+    {
+        return pv.moves[1];
+    }
+
+    // The PV was cut short (e.g. by a TT hit); fall back to the TT's reply
+    Board board = board_;
+    board.makeMove(best_move);
+
+    TTEntry entry;
+    if (tt_->probe(board.hash(), entry) && entry.move != Move::NO_MOVE &&
+        MovePicker::isLegal(board, entry.move))
+    {
+        return entry.move;
+    }
+
+    return Move::NO_MOVE;
+}
+
+SearchResult ChessEngine::aspirationSearch(Search &search, SearchInfo &info, int d, int pv_index,
+                                           int prev_score, bool report)
+{
+    // Shallow iterations and mate/tablebase scores are too unstable for a narrow window
+    if (d < ASPIRATION_MIN_DEPTH || std::abs(prev_score) > TB_WIN_IN_MAX_PLY)
+    {
+        return search.searchRoot(board_, d, info, -MATE_VALUE, MATE_VALUE, pv_index);
+    }
+
+    int delta = ASPIRATION_WINDOW;
+    int alpha = std::max(prev_score - delta, -MATE_VALUE);
+    int beta = std::min(prev_score + delta, MATE_VALUE);
+
+    while (true)
+    {
+        auto result = search.searchRoot(board_, d, info, alpha, beta, pv_index);
+
+        if (info.should_stop())
+        {
+            return result;
+        }
+
+        bool full_window = alpha <= -MATE_VALUE && beta >= MATE_VALUE;
+        if (full_window || (result.score > alpha && result.score < beta))
+        {
+            return result;
+        }
+
+        if (result.score <= alpha)
+        {
+            if (report)
+            {
+                reportIteration(d, pv_index, result, " upperbound");
+            }
+            // Fail low: pull beta toward the window so the re-search is cheaper
+            beta = (alpha + beta) / 2;
+            alpha = std::max(result.score - delta, -MATE_VALUE);
+        }
+        else
+        {
+            if (report)
+            {
+                reportIteration(d, pv_index, result, " lowerbound");
+            }
+            beta = std::min(result.score + delta, MATE_VALUE);
+        }
+
+        delta += delta / 2;
+        if (delta > ASPIRATION_MAX_WINDOW)
+        {
+            alpha = -MATE_VALUE;
+            beta = MATE_VALUE;
+        }
+    }
+}
+
+void ChessEngine::reportIteration(int d, int pv_index, const SearchResult &result, const char *bound)
+{
+    if (!reporting_)
+    {
+        return;
+    }
+
+    // Aspiration fail highs and lows of an iteration already reported are
+    // rate limited; a new depth and exact scores always go out
+    auto now = std::chrono::steady_clock::now();
+    bool exact = bound[0] == '\0';
+    if (!exact && d == last_info_depth_ && now - last_info_time_ < std::chrono::milliseconds(INFO_MIN_INTERVAL_MS))
+    {
+        return;
+    }
+    last_info_depth_ = d;
+    last_info_time_ = last_status_time_ = now;
+
+    int64_t elapsed = std::chrono::duration_cast<Duration>(now - search_info_.start_time).count();
+    uint64_t nodes = totalNodes();
+
+    std::ostringstream oss;
+    oss << "info depth " << d
+        << " seldepth " << search_info_.seldepth;
+    if (multi_pv_ > 1)
+    {
+        oss << " multipv " << pv_index + 1;
+    }
+    oss << " score cp " << result.score << bound
+        << " nodes " << nodes
+        << " nps " << nodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(1, elapsed))
+        << " hashfull " << tt_->getHashfull();
+
+    if (tablebase_->isAvailable())
+    {
+        oss << " tbhits " << totalTbHits();
+    }
+    oss << " time " << elapsed << " pv";
+
+    for (int i = 0; i < result.pv.count; ++i)
+    {
+        oss << " " << chess::uci::moveToUci(result.pv.moves[i]);
+    }
+    uciOutput().send(oss.str(), output_prefix_);
+}
+
+void ChessEngine::reportCurrentMove(int d, Move move, int number)
+{
+    // Only long searches; short ones would just flood the GUI
+    if (!reporting_)
+    {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    int64_t elapsed = std::chrono::duration_cast<Duration>(now - search_info_.start_time).count();
+    if (elapsed < CURRMOVE_MIN_MS)
+    {
+        return;
+    }
+
+    std::ostringstream oss;
+    oss << "info depth " << d << " currmove " << chess::uci::moveToUci(move) << " currmovenumber " << number;
+
+    // Between iterations, the search's progress once in a while
+    if (now - last_status_time_ >= std::chrono::milliseconds(STATUS_INTERVAL_MS))
+    {
+        last_status_time_ = now;
+        uint64_t nodes = totalNodes();
+        oss << "\ninfo nodes " << nodes
+            << " nps " << nodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(1, elapsed))
+            << " hashfull " << tt_->getHashfull();
+        if (tablebase_->isAvailable())
+        {
+            oss << " tbhits " << totalTbHits();
+        }
+        oss << " time " << elapsed;
+    }
+    uciOutput().send(oss.str(), output_prefix_);
+}
+
+void ChessEngine::resizeHelpers()
+{
+    size_t count = static_cast<size_t>(std::max(1, threads_) - 1);
+
+    while (helpers_.size() > count)
+    {
+        helpers_.pop_back();
+    }
+
+    while (helpers_.size() < count)
+    {
+        auto helper = std::make_unique<HelperThread>();
+        helper->search = std::make_unique<Search>(*tt_, *evaluation_);
+        helper->search->setNNUE(nnue_.get());
+        helper->search->setTablebase(tablebase_.get());
+        helpers_.push_back(std::move(helper));
+    }
+}
+
+void ChessEngine::runHelper(HelperThread &helper, int id, int max_depth)
+{
+    // Depth staggering: each helper skips a different subset of iterations
+    // so that the threads spread over several depths at once
+    static constexpr int SKIP_SIZE[20] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+    static constexpr int SKIP_PHASE[20] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+    int slot = (id - 1) % 20;
+
+    for (int d = 1; d <= max_depth && !helper.info.should_stop(); ++d)
+    {
+        if (((d + SKIP_PHASE[slot]) / SKIP_SIZE[slot]) % 2)
+        {
+            continue;
+        }
+
+        auto result = aspirationSearch(*helper.search, helper.info, d, 0, helper.result.score, false);
+
+        if (helper.info.should_stop())
+        {
+            break;
+        }
+
+        helper.result = result;
+        helper.completed_depth = d;
+
+        if (std::abs(result.score) > MATE_IN_MAX_PLY)
+        {
+            break;
+        }
+    }
+}
+
+void ChessEngine::startHelpers(int max_depth)
+{
+    // Only as many as the process-wide budget allows right now
+    active_helpers_ = SharedResources::acquireHelpers(static_cast<int>(helpers_.size()));
+
+    for (size_t i = 0; i < helpers_.size(); ++i)
+    {
+        HelperThread &helper = *helpers_[i];
+        // Helpers have no clock of their own; the main thread stops them
+        helper.info.reset();
+        helper.result = SearchResult{Move::NO_MOVE, -MATE_VALUE, 0, PVLine{}};
+        helper.completed_depth = 0;
+        if (static_cast<int>(i) >= active_helpers_)
+        {
+            continue;
+        }
+        int id = static_cast<int>(i) + 1;
+        helper.worker.run([this, &helper, id, max_depth]()
+                          { runHelper(helper, id, max_depth); });
+    }
+}
+
+void ChessEngine::stopHelpers()
+{
+    for (auto &helper : helpers_)
+    {
+        helper->info.stopped = true;
+    }
+
+    for (auto &helper : helpers_)
+    {
+        helper->worker.wait();
+    }
+
+    SharedResources::releaseHelpers(active_helpers_);
+    active_helpers_ = 0;
+}
+
+uint64_t ChessEngine::totalNodes() const
+{
+    uint64_t nodes = search_info_.nodes;
+    for (const auto &helper : helpers_)
+    {
+        nodes += helper->info.nodes;
+    }
+    return nodes;
+}
+
+SearchStats ChessEngine::searchStats() const
+{
+    SearchStats stats = search_->stats();
+    for (const auto &helper : helpers_)
+    {
+        stats.merge(helper->search->stats());
+    }
+    return stats;
+}
+
+uint64_t ChessEngine::totalTbHits() const
+{
+    uint64_t tbhits = search_info_.tbhits;
+    for (const auto &helper : helpers_)
+    {
+        tbhits += helper->info.tbhits;
+    }
+    return tbhits;
+}
+
 void ChessEngine::stopSearch()
 {
     search_info_.stopped = true;
-    searching_ = false;
-    if (search_thread_.joinable())
+    for (auto &helper : helpers_)
     {
-        search_thread_.join();
+        helper->info.stopped = true;
     }
 }
 
 void ChessEngine::setHashSize(int mb)
 {
+    // A shared table is sized by its owner
+    if (shared_tt_)
+    {
+        return;
+    }
+
+    // Reallocating a large table takes seconds; leave it to isready
+    waitForSearch();
     hash_size_mb_ = mb;
-    tt_ = std::make_unique<TranspositionTable>(mb);
-    search_->setTranspositionTable(*tt_);
+    tt_resize_pending_ = true;
 }
 
-void ChessEngine::setBookPath(const std::string &path)
+void ChessEngine::applyPendingChanges()
 {
-    book_path_ = path;
-    if (book_)
+    if (!tt_resize_pending_ && !tt_clear_pending_)
     {
-        book_->loadFromFile(path);
+        return;
     }
+
+    waitForSearch();
+    if (tt_resize_pending_)
+    {
+        tt_->resize(hash_size_mb_, clearThreads());
+    }
+    else
+    {
+        tt_->clear(clearThreads());
+    }
+    tt_resize_pending_ = tt_clear_pending_ = false;
+}
+
+int ChessEngine::clearThreads() const
+{
+    // No search runs while the table is cleared, so every core can help
+    return std::max(threads_, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+void ChessEngine::setBookPath(const std::string &path)
+{
+    waitForSearch();
+    book_path_ = path;
+    book_ = SharedResources::book(path);
 }
 
 void ChessEngine::setTablebases(const std::string &path)
 {
+    waitForSearch();
     tb_path_ = path;
-    // TODO: Initialize Syzygy tablebases
+
+    // Let go of the current tables first, so they can be replaced unless
+    // another engine still uses them
+    search_->setTablebase(nullptr);
+    for (auto &helper : helpers_)
+    {
+        helper->search->setTablebase(nullptr);
+    }
+    tablebase_.reset();
+    tablebase_ = SharedResources::tablebase(path);
+
+    search_->setTablebase(tablebase_.get());
+    for (auto &helper : helpers_)
+    {
+        helper->search->setTablebase(tablebase_.get());
+    }
+}
+
+void ChessEngine::setEvalFile(const std::string &path)
+{
+    waitForSearch();
+    eval_file_ = path;
+
+    // Fall back to the hand-crafted evaluation when no network is loaded
+    nnue_ = SharedResources::network(path);
+
+    search_->setNNUE(nnue_.get());
+    for (auto &helper : helpers_)
+    {
+        helper->search->setNNUE(nnue_.get());
+    }
+
+    // Static evals cached in the TT came from the previous backend; a
+    // shared table holds other games' entries and is left alone
+    tt_clear_pending_ = !shared_tt_;
+}
+
+void ChessEngine::setMoveOverhead(int ms)
+{
+    move_overhead_ = std::max(0, ms);
+}
+
+void ChessEngine::setMultiPV(int lines)
+{
+    multi_pv_ = std::clamp(lines, 1, MAX_MULTI_PV);
 }
 
 void ChessEngine::setThreads(int threads)
 {
-    threads_ = threads;
-    // TODO: Implement multi-threading
+    waitForSearch();
+    threads_ = std::max(1, threads);
+    resizeHelpers();
 }
 
 int ChessEngine::evaluate()
 {
+    if (nnue_)
+    {
+        return nnue_->evaluate(board_);
+    }
     return evaluation_->evaluate(board_);
 }
 
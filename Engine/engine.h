@@ -4,29 +4,68 @@
 #include <memory>
 #include <atomic>
 #include <thread>
+#include <vector>
+#include <functional>
 #include "types.h"
 #include "search.h"
 #include "evaluation.h"
+#include "nnue.h"
 #include "transposition.h"
 #include "book.h"
+#include "tablebase.h"
+#include "timeman.h"
+#include "worker.h"
+#include "resources.h"
 
 class ChessEngine {
 public:
-    ChessEngine();
+    // With shared_tt the engine searches that table instead of its own; it
+    // is then neither resized by Hash nor cleared by ucinewgame (server.h)
+    explicit ChessEngine(std::shared_ptr<TranspositionTable> shared_tt = nullptr);
     ~ChessEngine();
     
+    // Called on the search thread with the best and ponder moves
+    using BestMoveCallback = std::function<void(Move, Move)>;
+    
     // Main engine interface
     void newGame();
     void setPosition(const std::string& fen, const std::vector<std::string>& moves);
-    Move search(int depth = 0, int movetime = 0, int wtime = 0, int btime = 0, 
-                int winc = 0, int binc = 0, bool infinite = false);
+    // A legal move of the current position in UCI notation, NO_MOVE if not
+    Move parseMove(const std::string& uci) const;
+    
+    // Asynchronous search on the persistent search thread (UCI go)
+    void startSearch(const SearchLimits& limits, BestMoveCallback on_bestmove);
+    // Synchronous search on the calling thread (bench, tools)
+    Move search(const SearchLimits& limits);
     void stopSearch();
+    void waitForSearch();
+    
+    // Pondering (SearchLimits::ponder): ponderHit() turns the running
+    // search into a timed one without restarting it
+    void ponderHit();
+    Move getPonderMove() const { return ponder_move_; }
+    // Score of the last search's best move for the side to move (0 for book moves)
+    int getBestScore() const { return best_score_; }
     
     // Engine configuration
+    // Takes effect at the next applyPendingChanges()
     void setHashSize(int mb);
     void setBookPath(const std::string& path);
     void setTablebases(const std::string& path);
+    void setEvalFile(const std::string& path);
     void setThreads(int threads);
+    void setMoveOverhead(int ms);
+    void setMultiPV(int lines);  // Best lines reported per iteration
+    // Put in front of every line the engine sends (server session IDs)
+    void setOutputPrefix(const std::string& prefix) { output_prefix_ = prefix; }
+    const std::string& outputPrefix() const { return output_prefix_; }
+    // Off: no info lines at all (in-process matches)
+    void setReporting(bool enabled) { reporting_ = enabled; }
+    // Resize or clear the TT as requested by setHashSize(), newGame() and
+    // setEvalFile(). Called on isready and before every search, so the
+    // work lands where GUIs expect to wait.
+    void applyPendingChanges();
+    static constexpr int MAX_MULTI_PV = 256;
     
     // Analysis
     int evaluate();
@@ -38,25 +77,85 @@ public:
     
     // Search info
     const SearchInfo& getSearchInfo() const { return search_info_; }
+    uint64_t totalNodes() const;
+    uint64_t totalTbHits() const;
+    SearchStats searchStats() const;  // Summed over all threads for the last search
     
 private:
+    // Lazy SMP helper: an independent searcher sharing only the TT
+    struct HelperThread {
+        std::unique_ptr<Search> search;
+        SearchInfo info;
+        SearchResult result;
+        int completed_depth = 0;
+        WorkerThread worker;
+    };
+
     Board board_;
+    std::string position_fen_;                // Last setPosition(), for replaying only new moves
+    std::vector<std::string> position_moves_;
     std::unique_ptr<Search> search_;
     std::unique_ptr<Evaluation> evaluation_;
-    std::unique_ptr<TranspositionTable> tt_;
-    std::unique_ptr<OpeningBook> book_;
+    // Shared with other engines through SharedResources (or the server)
+    std::shared_ptr<const NNUEEvaluation> nnue_;
+    std::shared_ptr<TranspositionTable> tt_;
+    std::shared_ptr<OpeningBook> book_;
+    std::shared_ptr<Tablebase> tablebase_;
     
     SearchInfo search_info_;
+    TimeManager time_manager_;
     std::atomic<bool> searching_;
-    std::thread search_thread_;
+    std::atomic<bool> pondering_{false};
+    std::atomic<int64_t> ponder_offset_ms_{0};  // Time spent pondering before ponderhit
+    Move ponder_move_ = Move::NO_MOVE;
+    int best_score_ = 0;
+    std::vector<std::unique_ptr<HelperThread>> helpers_;
+    int active_helpers_ = 0;  // Helpers running this search, from SharedResources' budget
+    WorkerThread main_worker_;  // Last member: joined before the state it uses goes away
     
     // Configuration
     int hash_size_mb_;
     int threads_;
+    int move_overhead_;
+    int multi_pv_;
+    bool shared_tt_;
+    std::string output_prefix_;
+    bool reporting_ = true;
+    bool tt_resize_pending_ = false;
+    bool tt_clear_pending_ = false;
     std::string book_path_;
     std::string tb_path_;
+    std::string eval_file_;
+    
+    // Aspiration windows around the previous iteration's score
+    static constexpr int ASPIRATION_MIN_DEPTH = 4;
+    static constexpr int ASPIRATION_WINDOW = 40;
+    static constexpr int ASPIRATION_MAX_WINDOW = 500;
     
+    // Output pacing: bound-only info lines at most every INFO_MIN_INTERVAL_MS
+    // within an iteration; currmove from CURRMOVE_MIN_MS into the search,
+    // with nodes/nps/hashfull every STATUS_INTERVAL_MS between info lines
+    static constexpr int INFO_MIN_INTERVAL_MS = 100;
+    static constexpr int CURRMOVE_MIN_MS = 1000;
+    static constexpr int STATUS_INTERVAL_MS = 1000;
+    int last_info_depth_ = 0;
+    TimePoint last_info_time_;
+    TimePoint last_status_time_;
+
     void initializeComponents();
+    void prepareSearch(const SearchLimits& limits);
+    Move think(const SearchLimits& limits);
+    SearchResult aspirationSearch(Search& search, SearchInfo& info, int d, int pv_index,
+                                  int prev_score, bool report);
+    void reportIteration(int d, int pv_index, const SearchResult& result, const char* bound);
+    void reportCurrentMove(int d, Move move, int number);
+    void waitWhilePondering();
+    Move findPonderMove(Move best_move, const PVLine& pv);
+    void resizeHelpers();
+    int clearThreads() const;  // Threads used to clear the TT
+    void runHelper(HelperThread& helper, int id, int max_depth);
+    void startHelpers(int max_depth);
+    void stopHelpers();
 };
 
 #endif // ENGINE_H
\ No newline at end of file
@@ -1,46 +1,124 @@
 #include "evaluation.h"
 #include <algorithm>
 
-Evaluation::Evaluation() {}
-
-int Evaluation::evaluate(const Board &board)
+Evaluation::Evaluation()
 {
-    int mg_score = 0, eg_score = 0;
-    int phase = getPhase(board);
-
-    // Evaluate for both colors
     for (Color color : {Color::WHITE, Color::BLACK})
     {
-        int color_mg = 0, color_eg = 0;
-
-        // Material and piece-square tables
         for (PieceType piece_type : {PieceType::PAWN, PieceType::KNIGHT, PieceType::BISHOP,
                                      PieceType::ROOK, PieceType::QUEEN, PieceType::KING})
         {
+            int piece = static_cast<int>(Piece(piece_type, color));
+            int sign = (color == Color::WHITE) ? 1 : -1;
+            int value_mg = EvalParams::PIECE_VALUES_MG[static_cast<int>(piece_type)];
+            int value_eg = EvalParams::PIECE_VALUES_EG[static_cast<int>(piece_type)];
 
-            Bitboard pieces = board.pieces(piece_type, color);
-            while (pieces)
+            for (int sq = 0; sq < 64; ++sq)
             {
-                Square square = pieces.pop();
+                psq_mg_[piece][sq] = sign * (value_mg + getPieceSquareValue(piece_type, Square(sq), false, color == Color::WHITE));
+                psq_eg_[piece][sq] = sign * (value_eg + getPieceSquareValue(piece_type, Square(sq), true, color == Color::WHITE));
+            }
+        }
+    }
 
-                // Material value
-                color_mg += PIECE_VALUES[static_cast<int>(piece_type)];
-                color_eg += PIECE_VALUES[static_cast<int>(piece_type)];
+    for (int file = 0; file < 8; ++file)
+    {
+        adjacent_files_[file] = Bitboard(0);
+        if (file > 0)
+        {
+            adjacent_files_[file] |= Bitboard(chess::File(file - 1));
+        }
+        if (file < 7)
+        {
+            adjacent_files_[file] |= Bitboard(chess::File(file + 1));
+        }
+    }
 
-                // Piece-square table value
-                int pst_mg = getPieceSquareValue(piece_type, square, false, color == Color::WHITE);
-                int pst_eg = getPieceSquareValue(piece_type, square, true, color == Color::WHITE);
+    for (int sq = 0; sq < 64; ++sq)
+    {
+        int file = sq & 7, rank = sq >> 3;
+        Bitboard span = adjacent_files_[file] | Bitboard(chess::File(file));
+        passed_mask_[0][sq] = passed_mask_[1][sq] = Bitboard(0);
 
-                color_mg += pst_mg;
-                color_eg += pst_eg;
+        for (int r = 0; r < 8; ++r)
+        {
+            if (r > rank)
+            {
+                passed_mask_[0][sq] |= span & Bitboard(chess::Rank(r));
             }
+            if (r < rank)
+            {
+                passed_mask_[1][sq] |= span & Bitboard(chess::Rank(r));
+            }
+        }
+    }
+
+    // Fixed-seed splitmix64 so pawn keys are reproducible across runs
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (auto &color_keys : pawn_keys_)
+    {
+        for (uint64_t &key : color_keys)
+        {
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            key = z ^ (z >> 31);
+        }
+    }
+}
+
+int Evaluation::evaluate(const Board &board)
+{
+    EvalAccumulator acc;
+    initAccumulator(board, acc);
+    return evaluate(board, acc);
+}
+
+int Evaluation::evaluate(const Board &board, const EvalAccumulator &acc, PawnHashTable *pawn_table, AttackInfo *attacks)
+{
+    // Material and piece-square tables come from the accumulator
+    int mg_score = acc.mg, eg_score = acc.eg;
+    int phase = getPhase(acc);
+
+    // Pawn structure, from the pawn hash table when available
+    PawnEntry local_entry;
+    PawnEntry *pawns = &local_entry;
+    if (pawn_table)
+    {
+        pawns = &(*pawn_table)[acc.pawn_key];
+        if (pawns->key != acc.pawn_key)
+        {
+            pawns->key = acc.pawn_key;
+            evaluatePawns(board, *pawns);
         }
+    }
+    else
+    {
+        evaluatePawns(board, local_entry);
+    }
+
+    mg_score += pawns->mg;
+    eg_score += pawns->eg;
+
+    // Piece attacks, shared with the search when it passes its node's maps
+    AttackInfo local_attacks;
+    if (!attacks)
+    {
+        attacks = &local_attacks;
+    }
+    if (!attacks->has_attacks)
+    {
+        attacks->computeAttacks(board);
+    }
+
+    // Evaluate for both colors
+    for (Color color : {Color::WHITE, Color::BLACK})
+    {
+        int color_mg = 0, color_eg = 0;
 
         // Additional evaluation terms
-        color_mg += evaluatePawns(board, color);
-        color_eg += evaluatePawns(board, color);
-        color_mg += evaluateKingSafety(board, color);
-        color_mg += evaluateMobility(board, color);
+        evaluateKingSafety(board, *attacks, color, phase, color_mg, color_eg);
+        evaluateMobility(board, *attacks, color, color_mg, color_eg);
 
         if (color == Color::WHITE)
         {
@@ -61,6 +139,76 @@ int Evaluation::evaluate(const Board &board)
     return board.sideToMove() == Color::WHITE ? final_score : -final_score;
 }
 
+void Evaluation::initAccumulator(const Board &board, EvalAccumulator &acc) const
+{
+    acc = EvalAccumulator{};
+
+    Bitboard occupied = board.occ();
+    while (occupied)
+    {
+        Square square = occupied.pop();
+        addPiece(acc, board.at(square), square);
+    }
+}
+
+void Evaluation::updateAccumulator(const Board &board, const Move &move, EvalAccumulator &acc) const
+{
+    // Must be called before the move is made on the board
+    Square from = move.from();
+    Square to = move.to();
+    Piece piece = board.at(from);
+    Color us = board.sideToMove();
+
+    if (move.typeOf() == Move::CASTLING)
+    {
+        // chess.hpp encodes castling as king-takes-own-rook
+        bool king_side = to > from;
+        Square king_to(king_side ? chess::File::FILE_G : chess::File::FILE_C, from.rank());
+        Square rook_to(king_side ? chess::File::FILE_F : chess::File::FILE_D, from.rank());
+        Piece rook = board.at(to);
+
+        removePiece(acc, piece, from);
+        removePiece(acc, rook, to);
+        addPiece(acc, piece, king_to);
+        addPiece(acc, rook, rook_to);
+        return;
+    }
+
+    if (move.typeOf() == Move::ENPASSANT)
+    {
+        removePiece(acc, Piece(PieceType::PAWN, ~us), Square(to.index() ^ 8));
+    }
+    else if (board.at(to) != Piece::NONE)
+    {
+        removePiece(acc, board.at(to), to);
+    }
+
+    removePiece(acc, piece, from);
+    addPiece(acc, move.typeOf() == Move::PROMOTION ? Piece(move.promotionType(), us) : piece, to);
+}
+
+void Evaluation::addPiece(EvalAccumulator &acc, Piece piece, Square square) const
+{
+    acc.mg += psq_mg_[static_cast<int>(piece)][square.index()];
+    acc.eg += psq_eg_[static_cast<int>(piece)][square.index()];
+    acc.phase += PHASE_VALUES[static_cast<int>(piece.type())];
+    if (piece.type() == PieceType::PAWN)
+    {
+        acc.pawn_key ^= pawn_keys_[static_cast<int>(piece.color())][square.index()];
+    }
+}
+
+void Evaluation::removePiece(EvalAccumulator &acc, Piece piece, Square square) const
+{
+    acc.mg -= psq_mg_[static_cast<int>(piece)][square.index()];
+    acc.eg -= psq_eg_[static_cast<int>(piece)][square.index()];
+    acc.phase -= PHASE_VALUES[static_cast<int>(piece.type())];
+    if (piece.type() == PieceType::PAWN)
+    {
+        acc.pawn_key ^= pawn_keys_[static_cast<int>(piece.color())][square.index()];
+    }
+}
+
 int Evaluation::getMaterialBalance(const Board &board)
 {
     int white_material = getMaterialValue(board, Color::WHITE);
@@ -80,17 +228,17 @@ int Evaluation::getPieceSquareValue(PieceType piece, Square square, bool is_endg
     switch (static_cast<int>(piece))
     {
     case static_cast<int>(PieceType::PAWN):
-        return is_endgame ? PST_PAWN_EG[sq_index] : PST_PAWN_MG[sq_index];
+        return is_endgame ? EvalParams::PST_PAWN_EG[sq_index] : EvalParams::PST_PAWN_MG[sq_index];
     case static_cast<int>(PieceType::KNIGHT):
-        return is_endgame ? PST_KNIGHT_EG[sq_index] : PST_KNIGHT_MG[sq_index];
+        return is_endgame ? EvalParams::PST_KNIGHT_EG[sq_index] : EvalParams::PST_KNIGHT_MG[sq_index];
     case static_cast<int>(PieceType::BISHOP):
-        return is_endgame ? PST_BISHOP_EG[sq_index] : PST_BISHOP_MG[sq_index];
+        return is_endgame ? EvalParams::PST_BISHOP_EG[sq_index] : EvalParams::PST_BISHOP_MG[sq_index];
     case static_cast<int>(PieceType::ROOK):
-        return is_endgame ? PST_ROOK_EG[sq_index] : PST_ROOK_MG[sq_index];
+        return is_endgame ? EvalParams::PST_ROOK_EG[sq_index] : EvalParams::PST_ROOK_MG[sq_index];
     case static_cast<int>(PieceType::QUEEN):
-        return is_endgame ? PST_QUEEN_EG[sq_index] : PST_QUEEN_MG[sq_index];
+        return is_endgame ? EvalParams::PST_QUEEN_EG[sq_index] : EvalParams::PST_QUEEN_MG[sq_index];
     case static_cast<int>(PieceType::KING):
-        return is_endgame ? PST_KING_EG[sq_index] : PST_KING_MG[sq_index];
+        return is_endgame ? EvalParams::PST_KING_EG[sq_index] : EvalParams::PST_KING_MG[sq_index];
     default:
         return 0;
     }
@@ -103,7 +251,7 @@ int Evaluation::getMaterialValue(const Board &board, Color color)
     for (PieceType piece_type : {PieceType::PAWN, PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN, PieceType::KING})
     {
         int count = board.pieces(piece_type, color).count();
-        material += count * PIECE_VALUES[static_cast<int>(piece_type)];
+        material += count * EvalParams::PIECE_VALUES_MG[static_cast<int>(piece_type)];
     }
 
     return material;
@@ -125,141 +273,111 @@ int Evaluation::getPhase(const Board &board)
     return std::max(0, std::min(phase, TOTAL_PHASE));
 }
 
-int Evaluation::evaluatePawns(const Board &board, Color color)
+int Evaluation::getPhase(const EvalAccumulator &acc) const
+{
+    return std::max(0, std::min(TOTAL_PHASE - acc.phase, TOTAL_PHASE));
+}
+
+void Evaluation::evaluatePawns(const Board &board, PawnEntry &entry)
 {
-    int score = 0;
-    Bitboard pawns = board.pieces(PieceType::PAWN, color);
+    int white_mg = 0, white_eg = 0, black_mg = 0, black_eg = 0;
+    evaluatePawns(board, Color::WHITE, entry.passed[0], white_mg, white_eg);
+    evaluatePawns(board, Color::BLACK, entry.passed[1], black_mg, black_eg);
+
+    entry.mg = static_cast<int16_t>(white_mg - black_mg);
+    entry.eg = static_cast<int16_t>(white_eg - black_eg);
+}
+
+void Evaluation::evaluatePawns(const Board &board, Color color, Bitboard &passed, int &mg, int &eg)
+{
+    Bitboard own_pawns = board.pieces(PieceType::PAWN, color);
+    Bitboard enemy_pawns = board.pieces(PieceType::PAWN, ~color);
+    Bitboard pawns = own_pawns;
+    passed = Bitboard(0);
 
     while (pawns)
     {
         Square square = pawns.pop();
-        chess::File file = square.file();
+        int file = static_cast<int>(square.file());
 
         // Doubled pawns penalty
-        Bitboard file_pawns = board.pieces(PieceType::PAWN, color) & (Bitboard(0x0101010101010101ULL) << static_cast<int>(file));
-        if (file_pawns.count() > 1)
+        if ((own_pawns & Bitboard(square.file())).count() > 1)
         {
-            score -= 20;
+            mg += EvalParams::DOUBLED_PAWN_MG;
+            eg += EvalParams::DOUBLED_PAWN_EG;
         }
 
         // Isolated pawn penalty
-        Bitboard adjacent_files = Bitboard(0);
-        if (file != chess::File::FILE_A)
-        {
-            adjacent_files |= Bitboard(chess::File(static_cast<int>(file) - 1));
-        }
-        if (file != chess::File::FILE_H)
+        if ((own_pawns & adjacent_files_[file]).empty())
         {
-            adjacent_files |= Bitboard(chess::File(static_cast<int>(file) + 1));
+            mg += EvalParams::ISOLATED_PAWN_MG;
+            eg += EvalParams::ISOLATED_PAWN_EG;
         }
 
-        if ((board.pieces(PieceType::PAWN, color) & adjacent_files).empty())
+        // Passed pawn bonus: no enemy pawn in front on this or an adjacent file
+        if ((enemy_pawns & passed_mask_[static_cast<int>(color)][square.index()]).empty())
         {
-            score -= 15; // Isolated pawn
-        }
-
-        // Passed pawn bonus
-        bool is_passed = true;
-        chess::Direction forward = (color == Color::WHITE) ? chess::Direction::NORTH : chess::Direction::SOUTH;
-
-        for (int i = 0; i < 3; ++i)
-        { // Check files: left, center, right
-            int check_file_idx = static_cast<int>(file) - 1 + i;
-            if (check_file_idx < static_cast<int>(chess::File::FILE_A) || check_file_idx > static_cast<int>(chess::File::FILE_H))
-                continue;
-
-            Bitboard enemy_pawns_on_file = board.pieces(PieceType::PAWN, ~color) & Bitboard(chess::File(check_file_idx));
-
-            // Check if enemy pawn blocks or can capture
-            while (enemy_pawns_on_file)
-            {
-                Square enemy_sq = enemy_pawns_on_file.pop();
-                if ((color == Color::WHITE && enemy_sq.rank() > square.rank()) ||
-                    (color == Color::BLACK && enemy_sq.rank() < square.rank()))
-                {
-                    is_passed = false;
-                    break;
-                }
-            }
-            if (!is_passed)
-                break;
-        }
-
-        if (is_passed)
-        {
-            int rank_bonus = (color == Color::WHITE) ? static_cast<int>(square.rank()) : (7 - static_cast<int>(square.rank()));
-            score += 10 + rank_bonus * rank_bonus;
+            passed |= Bitboard::fromSquare(square);
+            int rank = (color == Color::WHITE) ? static_cast<int>(square.rank()) : (7 - static_cast<int>(square.rank()));
+            mg += EvalParams::PASSED_PAWN_MG[rank];
+            eg += EvalParams::PASSED_PAWN_EG[rank];
         }
     }
-
-    return score;
 }
 
-int Evaluation::evaluateKingSafety(const Board &board, Color color)
+void Evaluation::evaluateKingSafety(const Board &board, const AttackInfo &attacks, Color color, int phase, int &mg, int &eg)
 {
-    int score = 0;
     Square king_sq = board.kingSq(color);
 
-    // King on back rank bonus in middlegame
-    if (!isEndgame(board))
+    // Attack units: enemy attacks on the king and the squares around it
+    Bitboard zone = chess::attacks::king(king_sq) | Bitboard::fromSquare(king_sq);
+    for (PieceType piece_type : {PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN})
+    {
+        int index = static_cast<int>(piece_type) - 1;
+        Bitboard attackers = board.pieces(piece_type, ~color);
+        while (attackers)
+        {
+            int units = (attacks.piece_attacks[attackers.pop()] & zone).count();
+            mg += units * EvalParams::KING_ZONE_ATTACK_MG[index];
+            eg += units * EvalParams::KING_ZONE_ATTACK_EG[index];
+        }
+    }
+
+    // King on back rank bonus in middlegame (same threshold as isEndgame)
+    if (phase > 8)
     {
         bool on_back_rank = (color == Color::WHITE && king_sq.rank() == chess::Rank::RANK_1) ||
                             (color == Color::BLACK && king_sq.rank() == chess::Rank::RANK_8);
         if (on_back_rank)
         {
-            score += 10;
+            mg += EvalParams::KING_BACK_RANK_MG;
+            eg += EvalParams::KING_BACK_RANK_EG;
         }
 
         // Pawn shield bonus
-        Bitboard pawn_shield = chess::attacks::king(king_sq) &
-                               board.pieces(PieceType::PAWN, color);
-        score += pawn_shield.count() * 5;
+        int shield = (chess::attacks::king(king_sq) & board.pieces(PieceType::PAWN, color)).count();
+        mg += shield * EvalParams::KING_SHIELD_MG;
+        eg += shield * EvalParams::KING_SHIELD_EG;
     }
-
-    return score;
 }
 
-int Evaluation::evaluateMobility(const Board &board, Color color)
+void Evaluation::evaluateMobility(const Board &board, const AttackInfo &attacks, Color color, int &mg, int &eg)
 {
-    int mobility = 0;
-
-    // Knight mobility
-    Bitboard knights = board.pieces(PieceType::KNIGHT, color);
-    while (knights)
-    {
-        Square sq = knights.pop();
-        Bitboard moves = chess::attacks::knight(sq) & ~board.us(color);
-        mobility += moves.count() * 2;
-    }
-
-    // Bishop mobility
-    Bitboard bishops = board.pieces(PieceType::BISHOP, color);
-    while (bishops)
-    {
-        Square sq = bishops.pop();
-        Bitboard moves = chess::attacks::bishop(sq, board.occ()) & ~board.us(color);
-        mobility += moves.count() * 3;
-    }
-
-    // Rook mobility
-    Bitboard rooks = board.pieces(PieceType::ROOK, color);
-    while (rooks)
-    {
-        Square sq = rooks.pop();
-        Bitboard moves = chess::attacks::rook(sq, board.occ()) & ~board.us(color);
-        mobility += moves.count() * 2;
-    }
+    Bitboard targets = ~board.us(color);
 
-    // Queen mobility (reduced weight to avoid over-development)
-    Bitboard queens = board.pieces(PieceType::QUEEN, color);
-    while (queens)
+    // Squares attacked and not occupied by own pieces: N, B, R, Q
+    for (PieceType piece_type : {PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN})
     {
-        Square sq = queens.pop();
-        Bitboard moves = chess::attacks::queen(sq, board.occ()) & ~board.us(color);
-        mobility += moves.count() * 1;
+        int index = static_cast<int>(piece_type) - 1;
+        int mobility = 0;
+        Bitboard pieces = board.pieces(piece_type, color);
+        while (pieces)
+        {
+            mobility += (attacks.piece_attacks[pieces.pop()] & targets).count();
+        }
+        mg += mobility * EvalParams::MOBILITY_MG[index];
+        eg += mobility * EvalParams::MOBILITY_EG[index];
     }
-
-    return mobility;
 }
 
 Square Evaluation::flipSquare(Square square)
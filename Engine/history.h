@@ -0,0 +1,40 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "types.h"
+#include <cstdlib>
+#include <cstring>
+
+// Move ordering statistics. Entries are updated with the "gravity"
+// formula: a bonus moves an entry towards +-HISTORY_MAX in proportion to
+// the distance left, so values stay bounded without rescaling the tables.
+constexpr int HISTORY_MAX = 16384;
+
+using PieceToHistory = int16_t[12][64];  // [moved piece][to]
+
+inline void updateGravity(int16_t& entry, int bonus) {
+    bonus = std::clamp(bonus, -HISTORY_MAX, HISTORY_MAX);
+    entry += bonus - entry * std::abs(bonus) / HISTORY_MAX;
+}
+
+// Reward for the move that caused a cutoff; the moves tried before it get
+// the same amount as a malus
+inline int historyBonus(int depth) {
+    return std::min(16 * depth * depth + 32 * depth + 16, 1536);
+}
+
+struct HistoryTables {
+    int16_t butterfly[2][64][64];         // [color][from][to], quiet moves
+    PieceToHistory continuation[12][64];  // [previous piece][previous to], quiet moves
+    int16_t capture[12][64][6];           // [moved piece][to][captured type]
+    Move counter_moves[12][64];           // [previous piece][previous to]
+
+    void clear() {
+        std::memset(butterfly, 0, sizeof(butterfly));
+        std::memset(continuation, 0, sizeof(continuation));
+        std::memset(capture, 0, sizeof(capture));
+        std::fill(&counter_moves[0][0], &counter_moves[0][0] + 12 * 64, Move(Move::NO_MOVE));
+    }
+};
+
+#endif // HISTORY_H
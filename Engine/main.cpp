@@ -4,19 +4,75 @@
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <cstdlib>
 #include "chess.hpp"
 #include "engine.h"
 #include "uci.h"
+#include "bench.h"
+#include "solve.h"
+#include "tuner.h"
+#include "datagen.h"
+#include "uci_output.h"
+#include "server.h"
+#include "match.h"
 
-int main() {
+int main(int argc, char* argv[]) {
     // Initialize attack tables for chess.hpp
     chess::attacks::initAttacks();
     
+    // Many games in one process: chess_engine server [hash_mb] [threads] [sessions]
+    if (argc > 1 && std::string(argv[1]) == "server") {
+        int hash_mb = (argc > 2) ? std::atoi(argv[2]) : SERVER_DEFAULT_HASH_MB;
+        int threads = (argc > 3) ? std::atoi(argv[3]) : 0;
+        int sessions = (argc > 4) ? std::atoi(argv[4]) : SERVER_DEFAULT_SESSIONS;
+        return runServer(hash_mb, threads, sessions);
+    }
+    
+    // Engine-vs-engine testing: chess_engine match [key=value...] (see match.h)
+    if (argc > 1 && std::string(argv[1]) == "match") {
+        MatchSettings settings;
+        if (!parseMatchArgs(std::vector<std::string>(argv + 2, argv + argc), settings)) {
+            return 1;
+        }
+        return runMatch(settings);
+    }
+    
     // Create the chess engine
     ChessEngine engine;
     UCIHandler uci(engine);
     
-    std::cout.setf(std::ios::unitbuf); // Ensure immediate output
+    // Command-line benchmark: chess_engine bench [depth]
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        int depth = (argc > 2) ? std::atoi(argv[2]) : 7;
+        return runBench(engine, depth);
+    }
+    
+    // Puzzle suites: chess_engine solve <file> [threads] [movetime_ms]
+    if (argc > 2 && std::string(argv[1]) == "solve") {
+        int threads = (argc > 3) ? std::atoi(argv[3]) : 0;
+        int movetime = (argc > 4) ? std::atoi(argv[4]) : SOLVE_DEFAULT_MOVETIME_MS;
+        return runSolve(argv[2], threads, movetime);
+    }
+    
+    // Evaluation tuning: chess_engine tune <file> [epochs] [threads] [output]
+    if (argc > 2 && std::string(argv[1]) == "tune") {
+        int epochs = (argc > 3) ? std::atoi(argv[3]) : TUNE_DEFAULT_EPOCHS;
+        int threads = (argc > 4) ? std::atoi(argv[4]) : 0;
+        std::string output = (argc > 5) ? argv[5] : TUNE_DEFAULT_OUTPUT;
+        return runTune(argv[2], epochs, threads, output);
+    }
+    
+    // Self-play data: chess_engine datagen <output> [positions] [threads] [nodes] [depth]
+    if (argc > 2 && std::string(argv[1]) == "datagen") {
+        uint64_t positions = (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : DATAGEN_DEFAULT_POSITIONS;
+        int threads = (argc > 4) ? std::atoi(argv[4]) : 0;
+        int nodes = (argc > 5) ? std::atoi(argv[5]) : DATAGEN_DEFAULT_NODES;
+        int depth = (argc > 6) ? std::atoi(argv[6]) : 0;
+        return runDatagen(argv[2], positions, threads, nodes, depth);
+    }
+    
+    // GUI output is written by its own thread from here on
+    uciOutput().start();
     
     std::string line;
     while (std::getline(std::cin, line)) {
@@ -26,5 +82,8 @@ int main() {
         uci.processCommand(line);
     }
     
+    engine.stopSearch();
+    engine.waitForSearch();
+    uciOutput().stop();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,925 @@
+#include "match.h"
+#include "engine.h"
+#include "uci.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <csignal>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Start of a game: "startpos" or a FEN, then moves already played from it
+    struct Opening
+    {
+        std::string fen;
+        std::vector<std::string> moves;
+    };
+
+    // Common balanced openings, used without an openings file
+    const char *const BUILTIN_OPENINGS[] = {
+        "e2e4 e7e5 g1f3 b8c6 f1b5 a7a6",
+        "e2e4 e7e5 g1f3 b8c6 f1c4 f8c5",
+        "e2e4 e7e5 g1f3 b8c6 d2d4 e5d4",
+        "e2e4 e7e5 g1f3 g8f6",
+        "e2e4 e7e5 f2f4 e5f4",
+        "e2e4 c7c5 g1f3 d7d6 d2d4 c5d4",
+        "e2e4 c7c5 g1f3 b8c6",
+        "e2e4 c7c5 g1f3 e7e6",
+        "e2e4 c7c5 b1c3 b8c6",
+        "e2e4 c7c5 c2c3 g8f6",
+        "e2e4 e7e6 d2d4 d7d5",
+        "e2e4 c7c6 d2d4 d7d5",
+        "e2e4 d7d6 d2d4 g8f6",
+        "e2e4 d7d5 e4d5 d8d5",
+        "e2e4 g7g6 d2d4 f8g7",
+        "d2d4 d7d5 c2c4 e7e6",
+        "d2d4 d7d5 c2c4 c7c6",
+        "d2d4 d7d5 c2c4 d5c4",
+        "d2d4 d7d5 g1f3 g8f6 c1f4",
+        "d2d4 g8f6 c2c4 e7e6 g1f3 b7b6",
+        "d2d4 g8f6 c2c4 e7e6 b1c3 f8b4",
+        "d2d4 g8f6 c2c4 g7g6 b1c3 f8g7",
+        "d2d4 g8f6 c2c4 c7c5 d4d5 e7e6",
+        "d2d4 g8f6 g1f3 g7g6",
+        "d2d4 f7f5 g2g3 g8f6",
+        "c2c4 e7e5 b1c3 g8f6",
+        "c2c4 c7c5 g1f3 g8f6",
+        "g1f3 d7d5 g2g3 g8f6",
+    };
+
+    // The legal move of board written as uci, NO_MOVE if there is none
+    Move legalMove(const Board &board, const std::string &uci)
+    {
+        chess::Movelist moves;
+        chess::movegen::legalmoves(moves, board);
+        for (const auto &move : moves)
+        {
+            if (chess::uci::moveToUci(move) == uci)
+            {
+                return move;
+            }
+        }
+        return Move::NO_MOVE;
+    }
+
+    bool startBoard(const Opening &opening, Board &board)
+    {
+        if (!board.setFen(opening.fen == "startpos" ? std::string(chess::constants::STARTPOS) : opening.fen))
+        {
+            return false;
+        }
+        for (const auto &uci : opening.moves)
+        {
+            Move move = legalMove(board, uci);
+            if (move == Move::NO_MOVE)
+            {
+                return false;
+            }
+            board.makeMove(move);
+        }
+        return board.isGameOver().second == chess::GameResult::NONE;
+    }
+
+    // A FEN or EPD line (EPD operations are dropped) or UCI moves from the
+    // start position; false for blank lines, comments and unplayable lines
+    bool parseOpening(const std::string &line, Opening &opening)
+    {
+        std::istringstream iss(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (iss >> token)
+        {
+            tokens.push_back(token);
+        }
+        if (tokens.empty() || tokens[0][0] == '#')
+        {
+            return false;
+        }
+
+        opening = Opening{};
+        if (tokens[0].find('/') != std::string::npos)
+        {
+            if (tokens.size() < 4)
+            {
+                return false;
+            }
+            opening.fen = tokens[0] + " " + tokens[1] + " " + tokens[2] + " " + tokens[3];
+            // Move counters are optional in EPD
+            for (size_t i = 4; i < std::min<size_t>(tokens.size(), 6); ++i)
+            {
+                if (tokens[i].find_first_not_of("0123456789") != std::string::npos)
+                {
+                    break;
+                }
+                opening.fen += " " + tokens[i];
+            }
+        }
+        else
+        {
+            opening.fen = "startpos";
+            opening.moves = tokens;
+        }
+
+        Board board;
+        return startBoard(opening, board);
+    }
+
+    bool loadOpenings(const std::string &path, std::vector<Opening> &openings)
+    {
+        Opening opening;
+        if (path.empty())
+        {
+            for (const char *line : BUILTIN_OPENINGS)
+            {
+                if (parseOpening(line, opening))
+                {
+                    openings.push_back(opening);
+                }
+            }
+            return true;
+        }
+
+        std::ifstream file(path);
+        if (!file.is_open())
+        {
+            std::cerr << "Could not read " << path << std::endl;
+            return false;
+        }
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (parseOpening(line, opening))
+            {
+                openings.push_back(opening);
+            }
+        }
+        if (openings.empty())
+        {
+            std::cerr << "No playable openings in " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // One side of the board; the match only talks UCI-level moves to it
+    class MatchPlayer
+    {
+    public:
+        virtual ~MatchPlayer() = default;
+
+        virtual void newGame() = 0;
+        // Best move in UCI notation and its score for the side to move;
+        // false if the engine gave no move
+        virtual bool go(const Opening &start, const std::vector<std::string> &moves, const SearchLimits &limits,
+                        std::string &move, int &score) = 0;
+    };
+
+    // This build, searching on the match thread
+    class LocalPlayer : public MatchPlayer
+    {
+    public:
+        explicit LocalPlayer(const MatchEngine &config) : uci_(engine_)
+        {
+            engine_.setReporting(false);
+            engine_.setHashSize(MATCH_HASH_MB);
+            for (const auto &[name, value] : config.options)
+            {
+                uci_.processCommand("setoption name " + name + " value " + value);
+            }
+            engine_.applyPendingChanges();
+        }
+
+        void newGame() override
+        {
+            engine_.newGame();
+        }
+
+        bool go(const Opening &start, const std::vector<std::string> &moves, const SearchLimits &limits,
+                std::string &move, int &score) override
+        {
+            engine_.setPosition(start.fen, moves);
+            Move best = engine_.search(limits);
+            if (best == Move::NO_MOVE)
+            {
+                return false;
+            }
+            move = chess::uci::moveToUci(best);
+            score = engine_.getBestScore();
+            return true;
+        }
+
+    private:
+        ChessEngine engine_;
+        UCIHandler uci_;
+    };
+
+#if defined(__linux__)
+    // Another UCI engine on the other end of a pair of pipes
+    class ProcessPlayer : public MatchPlayer
+    {
+    public:
+        explicit ProcessPlayer(const MatchEngine &config)
+        {
+            // Close-on-exec, so no child inherits another engine's pipes
+            int to_child[2], from_child[2];
+            if (pipe2(to_child, O_CLOEXEC) != 0)
+            {
+                return;
+            }
+            if (pipe2(from_child, O_CLOEXEC) != 0)
+            {
+                close(to_child[0]);
+                close(to_child[1]);
+                return;
+            }
+
+            pid_ = fork();
+            if (pid_ == 0)
+            {
+                dup2(to_child[0], STDIN_FILENO);
+                dup2(from_child[1], STDOUT_FILENO);
+                execl("/bin/sh", "sh", "-c", config.command.c_str(), static_cast<char *>(nullptr));
+                _exit(127);
+            }
+
+            close(to_child[0]);
+            close(from_child[1]);
+            if (pid_ < 0)
+            {
+                close(to_child[1]);
+                close(from_child[0]);
+                return;
+            }
+            to_ = fdopen(to_child[1], "w");
+            from_ = fdopen(from_child[0], "r");
+
+            ready_ = to_ && from_ && send("uci") && waitFor("uciok");
+            for (const auto &[name, value] : config.options)
+            {
+                ready_ = ready_ && send("setoption name " + name + " value " + value);
+            }
+            ready_ = ready_ && send("isready") && waitFor("readyok");
+        }
+
+        ~ProcessPlayer() override
+        {
+            if (to_)
+            {
+                send("quit");
+                std::fclose(to_);
+            }
+            if (from_)
+            {
+                std::fclose(from_);
+            }
+            if (pid_ > 0)
+            {
+                waitpid(pid_, nullptr, 0);
+            }
+            std::free(buffer_);
+        }
+
+        bool ready() const { return ready_; }
+
+        void newGame() override
+        {
+            send("ucinewgame");
+            send("isready");
+            waitFor("readyok");
+        }
+
+        bool go(const Opening &start, const std::vector<std::string> &moves, const SearchLimits &limits,
+                std::string &move, int &score) override
+        {
+            std::ostringstream oss;
+            oss << "position " << (start.fen == "startpos" ? "startpos" : "fen " + start.fen);
+            if (!moves.empty())
+            {
+                oss << " moves";
+                for (const auto &uci : moves)
+                {
+                    oss << " " << uci;
+                }
+            }
+            oss << "\ngo";
+            if (limits.nodes > 0)
+            {
+                oss << " nodes " << limits.nodes;
+            }
+            if (limits.depth > 0)
+            {
+                oss << " depth " << limits.depth;
+            }
+            if (limits.wtime > 0 || limits.btime > 0)
+            {
+                oss << " wtime " << limits.wtime << " btime " << limits.btime
+                    << " winc " << limits.winc << " binc " << limits.binc;
+            }
+            if (!send(oss.str()))
+            {
+                return false;
+            }
+
+            score = 0;
+            std::string line;
+            while (readLine(line))
+            {
+                std::istringstream iss(line);
+                std::string token;
+                iss >> token;
+                if (token == "bestmove")
+                {
+                    return static_cast<bool>(iss >> move);
+                }
+                if (token != "info")
+                {
+                    continue;
+                }
+
+                // The last score before bestmove is the one played
+                while (iss >> token && token != "string")
+                {
+                    std::string kind;
+                    int value;
+                    if (token == "score" && iss >> kind >> value)
+                    {
+                        score = kind != "mate" ? value : value > 0 ? MATE_VALUE - value : -MATE_VALUE - value;
+                    }
+                }
+            }
+            return false;
+        }
+
+    private:
+        pid_t pid_ = -1;
+        FILE *to_ = nullptr;
+        FILE *from_ = nullptr;
+        char *buffer_ = nullptr;
+        size_t buffer_size_ = 0;
+        bool ready_ = false;
+
+        bool send(const std::string &text)
+        {
+            return std::fprintf(to_, "%s\n", text.c_str()) > 0 && std::fflush(to_) == 0;
+        }
+
+        bool readLine(std::string &line)
+        {
+            ssize_t length = getline(&buffer_, &buffer_size_, from_);
+            if (length < 0)
+            {
+                return false;
+            }
+            line.assign(buffer_, static_cast<size_t>(length));
+            while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+            {
+                line.pop_back();
+            }
+            return true;
+        }
+
+        bool waitFor(const std::string &reply)
+        {
+            std::string line;
+            while (readLine(line))
+            {
+                if (line.rfind(reply, 0) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+#endif
+
+    std::unique_ptr<MatchPlayer> makePlayer(const MatchEngine &config)
+    {
+        if (config.command.empty())
+        {
+            return std::make_unique<LocalPlayer>(config);
+        }
+#if defined(__linux__)
+        auto player = std::make_unique<ProcessPlayer>(config);
+        if (player->ready())
+        {
+            return player;
+        }
+        std::cerr << "Could not start " << config.command << std::endl;
+#else
+        std::cerr << "External engines are only supported on Linux: " << config.command << std::endl;
+#endif
+        return nullptr;
+    }
+
+    double scoreFromElo(double elo)
+    {
+        return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+    }
+
+    double eloFromScore(double score)
+    {
+        score = std::clamp(score, 1e-6, 1.0 - 1e-6);
+        return -400.0 * std::log10(1.0 / score - 1.0);
+    }
+
+    // Results from engines[0]'s side. A game pair is scored in half points
+    // (0 to 4); pairs[k] counts pairs worth k. Pairs share an opening, so
+    // their scores vary less than single games and the SPRT ends sooner.
+    struct MatchScore
+    {
+        uint64_t pairs[5] = {0, 0, 0, 0, 0};
+        uint64_t wins = 0;
+        uint64_t draws = 0;
+        uint64_t losses = 0;
+
+        uint64_t pairCount() const
+        {
+            return pairs[0] + pairs[1] + pairs[2] + pairs[3] + pairs[4];
+        }
+
+        uint64_t games() const { return wins + draws + losses; }
+
+        double score() const
+        {
+            uint64_t n = pairCount();
+            double total = 0.0;
+            for (int k = 0; k < 5; ++k)
+            {
+                total += k * 0.25 * pairs[k];
+            }
+            return n > 0 ? total / n : 0.5;
+        }
+
+        // Variance of one pair's score
+        double variance() const
+        {
+            uint64_t n = pairCount();
+            double mean = score(), total = 0.0;
+            for (int k = 0; k < 5; ++k)
+            {
+                total += pairs[k] * (k * 0.25 - mean) * (k * 0.25 - mean);
+            }
+            return n > 0 ? total / n : 0.0;
+        }
+
+        double elo() const { return eloFromScore(score()); }
+
+        // Half width of the 95% confidence interval
+        double eloError() const
+        {
+            uint64_t n = pairCount();
+            if (n == 0)
+            {
+                return 0.0;
+            }
+            double margin = 1.96 * std::sqrt(variance() / n);
+            return (eloFromScore(score() + margin) - eloFromScore(score() - margin)) / 2.0;
+        }
+
+        // Likelihood that engines[0] is the stronger one
+        double los() const
+        {
+            if (wins + losses == 0)
+            {
+                return 0.5;
+            }
+            return 0.5 * (1.0 + std::erf((static_cast<double>(wins) - losses) / std::sqrt(2.0 * (wins + losses))));
+        }
+
+        // Log-likelihood ratio of H1 (elo1) over H0 (elo0), in the normal
+        // approximation of the generalized SPRT
+        double llr(double elo0, double elo1) const
+        {
+            double var = variance();
+            if (var <= 0.0)
+            {
+                return 0.0;
+            }
+            double s0 = scoreFromElo(elo0), s1 = scoreFromElo(elo1);
+            return pairCount() * (s1 - s0) * (2.0 * score() - s0 - s1) / (2.0 * var);
+        }
+    };
+
+    struct MatchShared
+    {
+        std::mutex mutex;
+        MatchScore score;
+        std::atomic<int> next_pair{0};
+        std::atomic<bool> stop{false};
+        bool failed = false;
+        int pairs = 0;
+        const char *decision = nullptr;  // Accepted hypothesis, once the SPRT ends
+        TimePoint start;
+    };
+
+    bool sprtEnabled(const MatchSettings &settings)
+    {
+        return settings.elo1 > settings.elo0;
+    }
+
+    // LLR bounds: below lower accepts H0, above upper accepts H1
+    void sprtBounds(const MatchSettings &settings, double &lower, double &upper)
+    {
+        lower = std::log(settings.beta / (1.0 - settings.alpha));
+        upper = std::log((1.0 - settings.beta) / settings.alpha);
+    }
+
+    void printProgress(const MatchShared &shared, const MatchSettings &settings)
+    {
+        const MatchScore &score = shared.score;
+        std::cerr << std::fixed << std::setprecision(1)
+                  << "Games " << score.games() << ": +" << score.wins << " =" << score.draws << " -" << score.losses
+                  << "  Elo " << score.elo() << " +- " << score.eloError()
+                  << "  LOS " << score.los() * 100.0 << "%";
+        if (sprtEnabled(settings))
+        {
+            double lower, upper;
+            sprtBounds(settings, lower, upper);
+            std::cerr << std::setprecision(2) << "  LLR " << score.llr(settings.elo0, settings.elo1)
+                      << " (" << lower << ", " << upper << ")";
+        }
+        std::cerr << std::endl;
+    }
+
+    // Plays one game; returns the result for white (0 loss, 1 draw, 2 win).
+    // note says why a game ended early on an engine failure.
+    int playGame(MatchPlayer &white, MatchPlayer &black, const std::string &white_name,
+                 const std::string &black_name, const Opening &opening, const MatchSettings &settings,
+                 std::string &note)
+    {
+        Board board;
+        startBoard(opening, board);
+        std::vector<std::string> moves = opening.moves;
+        white.newGame();
+        black.newGame();
+
+        int64_t clocks[2] = {settings.time_ms, settings.time_ms};
+        int win_plies = 0;  // Positive while white is winning, negative while black is
+        int draw_plies = 0;
+
+        for (int ply = 0; ply < MATCH_MAX_PLIES; ++ply)
+        {
+            auto [reason, game_result] = board.isGameOver();
+            if (game_result != chess::GameResult::NONE)
+            {
+                // A decided game is always lost by the side to move
+                if (reason == chess::GameResultReason::CHECKMATE)
+                {
+                    return board.sideToMove() == Color::WHITE ? 0 : 2;
+                }
+                return 1;
+            }
+
+            int side = board.sideToMove() == Color::WHITE ? 0 : 1;
+            MatchPlayer &player = side == 0 ? white : black;
+            const std::string &name = side == 0 ? white_name : black_name;
+            int loss = side == 0 ? 0 : 2;
+
+            SearchLimits limits;
+            limits.nodes = settings.nodes;
+            limits.depth = settings.depth;
+            if (settings.time_ms > 0)
+            {
+                // A zero clock would read as "no clock"
+                limits.wtime = static_cast<int>(std::max<int64_t>(1, clocks[0]));
+                limits.btime = static_cast<int>(std::max<int64_t>(1, clocks[1]));
+                limits.winc = limits.binc = settings.inc_ms;
+            }
+
+            std::string uci;
+            int score = 0;
+            auto start = std::chrono::steady_clock::now();
+            bool played = player.go(opening, moves, limits, uci, score);
+            int64_t elapsed = std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - start).count();
+
+            Move move = played ? legalMove(board, uci) : Move(Move::NO_MOVE);
+            if (move == Move::NO_MOVE)
+            {
+                note = played ? name + " played an illegal move " + uci : name + " gave no move";
+                return loss;
+            }
+            if (settings.time_ms > 0)
+            {
+                clocks[side] -= elapsed;
+                if (clocks[side] < 0)
+                {
+                    note = name + " lost on time";
+                    return loss;
+                }
+                clocks[side] += settings.inc_ms;
+            }
+
+            int white_score = side == 0 ? score : -score;
+            if (white_score >= MATCH_WIN_SCORE)
+            {
+                win_plies = std::max(win_plies, 0) + 1;
+            }
+            else if (white_score <= -MATCH_WIN_SCORE)
+            {
+                win_plies = std::min(win_plies, 0) - 1;
+            }
+            else
+            {
+                win_plies = 0;
+            }
+            draw_plies = (ply >= MATCH_DRAW_MIN_PLY && std::abs(white_score) <= MATCH_DRAW_SCORE) ? draw_plies + 1 : 0;
+            if (std::abs(win_plies) >= MATCH_WIN_PLIES)
+            {
+                return win_plies > 0 ? 2 : 0;
+            }
+            if (draw_plies >= MATCH_DRAW_PLIES)
+            {
+                return 1;
+            }
+
+            board.makeMove(move);
+            moves.push_back(uci);
+        }
+        return 1;
+    }
+
+    void matchThread(MatchShared &shared, const MatchSettings &settings, const std::vector<Opening> &openings)
+    {
+        auto first = makePlayer(settings.engines[0]);
+        auto second = makePlayer(settings.engines[1]);
+        if (!first || !second)
+        {
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.failed = true;
+            shared.stop = true;
+            return;
+        }
+        const std::string &first_name = settings.engines[0].name;
+        const std::string &second_name = settings.engines[1].name;
+
+        while (!shared.stop.load(std::memory_order_relaxed))
+        {
+            int pair = shared.next_pair.fetch_add(1);
+            if (pair >= shared.pairs)
+            {
+                break;
+            }
+
+            // The opening once with either colour, both results from engines[0]'s side
+            const Opening &opening = openings[pair % openings.size()];
+            std::string notes[2];
+            int results[2];
+            results[0] = playGame(*first, *second, first_name, second_name, opening, settings, notes[0]);
+            results[1] = 2 - playGame(*second, *first, second_name, first_name, opening, settings, notes[1]);
+
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            MatchScore &score = shared.score;
+            for (int i = 0; i < 2; ++i)
+            {
+                if (!notes[i].empty())
+                {
+                    std::cerr << notes[i] << std::endl;
+                }
+                (results[i] == 2 ? score.wins : results[i] == 1 ? score.draws : score.losses)++;
+            }
+            ++score.pairs[results[0] + results[1]];
+
+            if (score.pairCount() % MATCH_REPORT_PAIRS == 0)
+            {
+                printProgress(shared, settings);
+            }
+
+            if (sprtEnabled(settings) && !shared.decision)
+            {
+                double lower, upper;
+                sprtBounds(settings, lower, upper);
+                double llr = score.llr(settings.elo0, settings.elo1);
+                if (llr <= lower || llr >= upper)
+                {
+                    shared.decision = llr >= upper ? "H1" : "H0";
+                    shared.stop = true;
+                }
+            }
+        }
+    }
+
+    std::string limitText(const MatchSettings &settings)
+    {
+        std::ostringstream oss;
+        if (settings.nodes > 0)
+        {
+            oss << settings.nodes << " nodes";
+        }
+        if (settings.depth > 0)
+        {
+            oss << (settings.nodes > 0 ? " / " : "") << "depth " << settings.depth;
+        }
+        if (settings.nodes > 0 || settings.depth > 0)
+        {
+            oss << " per move" << (settings.time_ms > 0 ? ", " : "");
+        }
+        if (settings.time_ms > 0)
+        {
+            oss << "tc " << settings.time_ms / 1000.0 << "+" << settings.inc_ms / 1000.0 << "s";
+        }
+        return oss.str();
+    }
+}
+
+bool parseMatchArgs(const std::vector<std::string> &args, MatchSettings &settings)
+{
+    for (const auto &arg : args)
+    {
+        size_t eq = arg.find('=');
+        if (eq == std::string::npos || eq == 0)
+        {
+            std::cerr << "Expected key=value, got " << arg << std::endl;
+            return false;
+        }
+        std::string key = arg.substr(0, eq);
+        std::string value = arg.substr(eq + 1);
+
+        if (key.size() > 2 && (key[0] == 'a' || key[0] == 'b') && key[1] == '.')
+        {
+            // a.cmd, a.name, or a UCI option for that engine
+            MatchEngine &engine = settings.engines[key[0] == 'a' ? 0 : 1];
+            std::string field = key.substr(2);
+            if (field == "cmd")
+            {
+                engine.command = value;
+            }
+            else if (field == "name")
+            {
+                engine.name = value;
+            }
+            else
+            {
+                engine.options.emplace_back(field, value);
+            }
+        }
+        else if (key == "openings")
+        {
+            settings.openings = value;
+        }
+        else if (key == "games")
+        {
+            settings.games = std::atoi(value.c_str());
+        }
+        else if (key == "concurrency")
+        {
+            settings.concurrency = std::atoi(value.c_str());
+        }
+        else if (key == "nodes")
+        {
+            settings.nodes = std::strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (key == "depth")
+        {
+            settings.depth = std::atoi(value.c_str());
+        }
+        else if (key == "tc")
+        {
+            // Seconds, with an optional increment: 10+0.1
+            char *end = nullptr;
+            double base = std::strtod(value.c_str(), &end);
+            double inc = (*end == '+') ? std::strtod(end + 1, nullptr) : 0.0;
+            settings.time_ms = static_cast<int>(base * 1000.0);
+            settings.inc_ms = static_cast<int>(inc * 1000.0);
+        }
+        else if (key == "sprt")
+        {
+            if (value == "off")
+            {
+                settings.elo0 = settings.elo1 = 0.0;
+            }
+            else if (std::sscanf(value.c_str(), "%lf,%lf", &settings.elo0, &settings.elo1) != 2)
+            {
+                std::cerr << "Expected sprt=<elo0>,<elo1> or sprt=off, got " << arg << std::endl;
+                return false;
+            }
+        }
+        else if (key == "alpha")
+        {
+            settings.alpha = std::atof(value.c_str());
+        }
+        else if (key == "beta")
+        {
+            settings.beta = std::atof(value.c_str());
+        }
+        else
+        {
+            std::cerr << "Unknown match setting " << key << std::endl;
+            return false;
+        }
+    }
+
+    if (settings.games < 1 || settings.alpha <= 0.0 || settings.alpha >= 1.0 ||
+        settings.beta <= 0.0 || settings.beta >= 1.0)
+    {
+        std::cerr << "games must be positive, alpha and beta between 0 and 1" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int runMatch(const MatchSettings &settings)
+{
+    MatchSettings match = settings;
+    if (match.nodes == 0 && match.depth <= 0 && match.time_ms <= 0)
+    {
+        match.nodes = MATCH_DEFAULT_NODES;
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        if (match.engines[i].name.empty())
+        {
+            match.engines[i].name = i == 0 ? "A" : "B";
+        }
+#if defined(__linux__)
+        // A crashed engine must cost it the game, not end the match
+        if (!match.engines[i].command.empty())
+        {
+            std::signal(SIGPIPE, SIG_IGN);
+        }
+#endif
+    }
+
+    std::vector<Opening> openings;
+    if (!loadOpenings(match.openings, openings))
+    {
+        return 1;
+    }
+
+    MatchShared shared;
+    shared.pairs = (match.games + 1) / 2;
+    int threads = match.concurrency > 0 ? match.concurrency : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    threads = std::min(threads, shared.pairs);
+
+    std::cerr << match.engines[0].name << " vs " << match.engines[1].name << ": up to " << shared.pairs * 2
+              << " games from " << openings.size() << " openings, " << limitText(match) << ", "
+              << threads << " at a time";
+    if (sprtEnabled(match))
+    {
+        std::cerr << ", SPRT [" << match.elo0 << ", " << match.elo1 << "] alpha " << match.alpha
+                  << " beta " << match.beta;
+    }
+    std::cerr << std::endl;
+
+    shared.start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(matchThread, std::ref(shared), std::cref(match), std::cref(openings));
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    if (shared.failed)
+    {
+        return 1;
+    }
+
+    int64_t wall_ms = std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - shared.start).count();
+    const MatchScore &score = shared.score;
+    double llr = score.llr(match.elo0, match.elo1);
+
+    std::cerr << "===========================" << std::endl;
+    printProgress(shared, match);
+    std::cerr << "Pentanomial    : [" << score.pairs[0] << ", " << score.pairs[1] << ", " << score.pairs[2]
+              << ", " << score.pairs[3] << ", " << score.pairs[4] << "]" << std::endl
+              << "Wall time (ms) : " << wall_ms << std::endl;
+    if (sprtEnabled(match))
+    {
+        std::cerr << "SPRT           : " << (shared.decision ? std::string(shared.decision) + " accepted" : "inconclusive")
+                  << std::endl;
+    }
+
+    // Machine-readable summary on stdout; the report above goes to stderr
+    std::cout << std::fixed << std::setprecision(2)
+              << "{\"games\":" << score.games()
+              << ",\"wins\":" << score.wins
+              << ",\"draws\":" << score.draws
+              << ",\"losses\":" << score.losses
+              << ",\"pentanomial\":[" << score.pairs[0] << "," << score.pairs[1] << "," << score.pairs[2]
+              << "," << score.pairs[3] << "," << score.pairs[4] << "]"
+              << ",\"elo\":" << score.elo()
+              << ",\"elo_error\":" << score.eloError()
+              << ",\"los\":" << score.los()
+              << ",\"llr\":" << (sprtEnabled(match) ? llr : 0.0)
+              << ",\"sprt\":\"" << (shared.decision ? shared.decision : "none") << "\""
+              << ",\"wall_ms\":" << wall_ms << "}" << std::endl;
+    return 0;
+}
@@ -0,0 +1,64 @@
+#ifndef MATCH_H
+#define MATCH_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Match settings; in-process engines get MATCH_HASH_MB unless Hash is set
+constexpr int MATCH_HASH_MB = 16;
+constexpr uint64_t MATCH_DEFAULT_NODES = 20000;  // Per move when no nodes, depth or tc is given
+constexpr int MATCH_DEFAULT_GAMES = 20000;
+constexpr int MATCH_REPORT_PAIRS = 10;            // Progress line every this many game pairs
+constexpr int MATCH_MAX_PLIES = 400;              // Longer games are adjudicated drawn
+// Adjudication: a win once the movers' scores stay beyond WIN_SCORE for the
+// same side for WIN_PLIES plies, a draw once they stay within DRAW_SCORE for
+// DRAW_PLIES plies after DRAW_MIN_PLY
+constexpr int MATCH_WIN_SCORE = 1000;
+constexpr int MATCH_WIN_PLIES = 6;
+constexpr int MATCH_DRAW_SCORE = 10;
+constexpr int MATCH_DRAW_PLIES = 12;
+constexpr int MATCH_DRAW_MIN_PLY = 80;
+
+// One side of a match: this build with its own UCI options, or any other
+// UCI engine (typically an older build of this one) run as a child process
+struct MatchEngine {
+    std::string name;
+    std::string command;  // Run through /bin/sh; empty = in-process ChessEngine
+    std::vector<std::pair<std::string, std::string>> options;  // setoption name/value
+};
+
+struct MatchSettings {
+    std::string openings;  // File of FEN/EPD lines or UCI move lines; empty = built-in suite
+    MatchEngine engines[2];
+    int games = MATCH_DEFAULT_GAMES;
+    int concurrency = 0;   // Games played at once, 0 = all cores
+    // Per move: a node budget and/or depth, or a clock of time_ms + inc_ms
+    uint64_t nodes = 0;
+    int depth = 0;
+    int time_ms = 0;
+    int inc_ms = 0;
+    // SPRT of H0: elo = elo0 against H1: elo = elo1 (off when elo1 <= elo0)
+    double elo0 = 0.0;
+    double elo1 = 5.0;
+    double alpha = 0.05;
+    double beta = 0.05;
+};
+
+// Command line of the match mode, key=value arguments:
+//   openings=<file> games=<n> concurrency=<n> nodes=<n> depth=<n>
+//   tc=<seconds>[+<increment>] sprt=<elo0>,<elo1>|off alpha=<a> beta=<b>
+//   a.cmd=<command> a.name=<name> a.<UCI option>=<value> (same for b.)
+// False (after printing why) on anything it doesn't understand.
+bool parseMatchArgs(const std::vector<std::string>& args, MatchSettings& settings);
+
+// Plays engines[0] against engines[1] in game pairs, each opening once with
+// either colour, on several threads. Stops after games games or as soon as
+// the SPRT accepts either hypothesis. Progress and the final W/D/L, Elo with
+// its 95% interval, LOS and LLR (all from a pentanomial model of the pairs)
+// go to stderr, a JSON summary to stdout. Returns non-zero if the openings
+// can't be read or an engine can't be started.
+int runMatch(const MatchSettings& settings);
+
+#endif // MATCH_H
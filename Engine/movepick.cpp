@@ -0,0 +1,225 @@
+#include "movepick.h"
+#include "see.h"
+#include <algorithm>
+
+MovePicker::MovePicker(const Board &board, Move tt_move, const int killers[2], Move counter_move,
+                       const HistoryTables &history, const PieceToHistory *const cont[2])
+    : board_(board), history_(history), cont_{cont[0], cont[1]}, tt_move_(tt_move),
+      counter_move_(counter_move), stage_(TT_MOVE), killer_index_(0), current_(0), bad_count_(0),
+      bad_current_(0)
+{
+    killers_[0] = Move(static_cast<uint16_t>(killers[0]));
+    killers_[1] = Move(static_cast<uint16_t>(killers[1]));
+
+    if (tt_move_ == Move::NO_MOVE || !isLegal(board_, tt_move_))
+    {
+        tt_move_ = Move::NO_MOVE;
+        stage_ = GEN_CAPTURES;
+    }
+}
+
+MovePicker::MovePicker(const Board &board, const HistoryTables &history)
+    : board_(board), history_(history), cont_{nullptr, nullptr}, tt_move_(Move::NO_MOVE),
+      counter_move_(Move::NO_MOVE), stage_(QS_GEN_CAPTURES), killer_index_(0), current_(0), bad_count_(0),
+      bad_current_(0)
+{
+    killers_[0] = killers_[1] = Move::NO_MOVE;
+}
+
+Move MovePicker::next()
+{
+    switch (stage_)
+    {
+    case TT_MOVE:
+        stage_ = GEN_CAPTURES;
+        return tt_move_;
+
+    case GEN_CAPTURES:
+        chess::movegen::legalmoves<chess::movegen::MoveGenType::CAPTURE>(moves_, board_);
+        scoreCaptures();
+        current_ = 0;
+        stage_ = GOOD_CAPTURES;
+        [[fallthrough]];
+
+    case GOOD_CAPTURES:
+        while (current_ < static_cast<int>(moves_.size()))
+        {
+            Move move = selectBest();
+            if (move == tt_move_)
+            {
+                continue;
+            }
+
+            // Losing captures are tried after the quiet moves
+            if (!see(board_, move, 0))
+            {
+                bad_captures_[bad_count_++] = move;
+                continue;
+            }
+
+            return move;
+        }
+        stage_ = KILLERS;
+        [[fallthrough]];
+
+    case KILLERS:
+        while (killer_index_ < 2)
+        {
+            Move killer = killers_[killer_index_++];
+            if (killer != Move::NO_MOVE && killer != tt_move_ && !board_.isCapture(killer) &&
+                (killer_index_ == 1 || killer != killers_[0]) && isLegal(board_, killer))
+            {
+                return killer;
+            }
+        }
+        stage_ = COUNTER_MOVE;
+        [[fallthrough]];
+
+    case COUNTER_MOVE:
+        stage_ = GEN_QUIETS;
+        if (counter_move_ != Move::NO_MOVE && counter_move_ != tt_move_ && counter_move_ != killers_[0] &&
+            counter_move_ != killers_[1] && !board_.isCapture(counter_move_) && isLegal(board_, counter_move_))
+        {
+            return counter_move_;
+        }
+        [[fallthrough]];
+
+    case GEN_QUIETS:
+        moves_.clear();
+        chess::movegen::legalmoves<chess::movegen::MoveGenType::QUIET>(moves_, board_);
+        scoreQuiets();
+        current_ = 0;
+        stage_ = QUIETS;
+        [[fallthrough]];
+
+    case QUIETS:
+        while (current_ < static_cast<int>(moves_.size()))
+        {
+            Move move = selectBest();
+            if (!isSpecial(move))
+            {
+                return move;
+            }
+        }
+        stage_ = BAD_CAPTURES;
+        [[fallthrough]];
+
+    case BAD_CAPTURES:
+        if (bad_current_ < bad_count_)
+        {
+            return bad_captures_[bad_current_++];
+        }
+        stage_ = DONE;
+        return Move::NO_MOVE;
+
+    case QS_GEN_CAPTURES:
+        chess::movegen::legalmoves<chess::movegen::MoveGenType::CAPTURE>(moves_, board_);
+        scoreCaptures();
+        current_ = 0;
+        stage_ = QS_CAPTURES;
+        [[fallthrough]];
+
+    case QS_CAPTURES:
+        if (current_ < static_cast<int>(moves_.size()))
+        {
+            return selectBest();
+        }
+        stage_ = DONE;
+        return Move::NO_MOVE;
+
+    default:
+        return Move::NO_MOVE;
+    }
+}
+
+void MovePicker::scoreCaptures()
+{
+    for (auto &move : moves_)
+    {
+        // En passant captures a pawn that is not on the target square
+        auto victim = move.typeOf() == Move::ENPASSANT ? PieceType(PieceType::PAWN) : board_.at(move.to()).type();
+        Piece attacker = board_.at(move.from());
+        int score = MVV_LVA[static_cast<int>(victim)][static_cast<int>(attacker.type())] * 256;
+
+        // Capture history breaks ties within a victim class
+        score += history_.capture[static_cast<int>(attacker)][move.to().index()][static_cast<int>(victim)] / 64;
+
+        // Promotion captures go first within their victim class
+        if (move.typeOf() == Move::PROMOTION && move.promotionType() == PieceType::QUEEN)
+        {
+            score += 1536;
+        }
+
+        move.setScore(static_cast<int16_t>(score));
+    }
+}
+
+void MovePicker::scoreQuiets()
+{
+    for (auto &move : moves_)
+    {
+        Piece piece = board_.at(move.from());
+        int to = move.to().index();
+        int score = history_.butterfly[static_cast<int>(board_.sideToMove())][move.from().index()][to];
+        for (const PieceToHistory *cont : cont_)
+        {
+            if (cont)
+            {
+                score += (*cont)[static_cast<int>(piece)][to];
+            }
+        }
+
+        // Quiet queen promotions ahead of ordinary quiet moves
+        if (move.typeOf() == Move::PROMOTION && move.promotionType() == PieceType::QUEEN)
+        {
+            score = 30000;
+        }
+
+        move.setScore(static_cast<int16_t>(std::clamp(score, -30000, 30000)));
+    }
+}
+
+Move MovePicker::selectBest()
+{
+    // Partial selection sort: bring the best remaining move to current_
+    int best = current_;
+    for (int i = current_ + 1; i < static_cast<int>(moves_.size()); ++i)
+    {
+        if (moves_[i].score() > moves_[best].score())
+        {
+            best = i;
+        }
+    }
+
+    std::swap(moves_[current_], moves_[best]);
+    return moves_[current_++];
+}
+
+bool MovePicker::isSpecial(const Move &move) const
+{
+    return move == tt_move_ || move == killers_[0] || move == killers_[1] || move == counter_move_;
+}
+
+bool MovePicker::isLegal(const Board &board, const Move &move)
+{
+    // Validate a move from the TT or killer slots by generating only the
+    // moves of the piece type standing on its origin square
+    Piece piece = board.at(move.from());
+    if (piece == Piece::NONE || piece.color() != board.sideToMove())
+    {
+        return false;
+    }
+
+    chess::Movelist moves;
+    chess::movegen::legalmoves(moves, board, 1 << static_cast<int>(piece.type()));
+
+    for (const auto &legal : moves)
+    {
+        if (legal == move)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
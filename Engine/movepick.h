@@ -0,0 +1,67 @@
+#ifndef MOVEPICK_H
+#define MOVEPICK_H
+
+#include "types.h"
+#include "history.h"
+
+// Staged move picker: the TT move is tried before any generation, then
+// captures and quiet moves are generated lazily, scored once each and picked
+// with a partial selection sort. Captures losing material by SEE are deferred
+// until after the quiet moves.
+class MovePicker {
+public:
+    // Main search. cont holds the continuation histories of the moves one
+    // and two plies back (either may be null).
+    MovePicker(const Board& board, Move tt_move, const int killers[2], Move counter_move,
+               const HistoryTables& history, const PieceToHistory* const cont[2]);
+    // Quiescence search: captures only, ordered by MVV-LVA and capture history
+    MovePicker(const Board& board, const HistoryTables& history);
+
+    Move next();
+
+    // Checks a move from an untrusted source (TT, killers, book) against
+    // the moves of the piece on its origin square
+    static bool isLegal(const Board& board, const Move& move);
+
+    // Whether the move most recently returned is a capture stage move
+    bool isCaptureStage() const { return stage_ == GOOD_CAPTURES || stage_ == BAD_CAPTURES || stage_ == QS_CAPTURES; }
+    // Whether it is a capture that loses material by SEE
+    bool isBadCaptureStage() const { return stage_ == BAD_CAPTURES; }
+
+private:
+    enum Stage {
+        TT_MOVE,
+        GEN_CAPTURES,
+        GOOD_CAPTURES,
+        KILLERS,
+        COUNTER_MOVE,
+        GEN_QUIETS,
+        QUIETS,
+        BAD_CAPTURES,
+        QS_GEN_CAPTURES,
+        QS_CAPTURES,
+        DONE
+    };
+
+    const Board& board_;
+    const HistoryTables& history_;
+    const PieceToHistory* cont_[2];
+    Move tt_move_;
+    Move killers_[2];
+    Move counter_move_;
+    int stage_;
+    int killer_index_;
+
+    chess::Movelist moves_;
+    int current_;
+    Move bad_captures_[chess::constants::MAX_MOVES];
+    int bad_count_;
+    int bad_current_;
+
+    void scoreCaptures();
+    void scoreQuiets();
+    Move selectBest();
+    bool isSpecial(const Move& move) const;
+};
+
+#endif // MOVEPICK_H
@@ -0,0 +1,286 @@
+#include "nnue.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX512BW__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Clipped ReLU of the accumulator dotted with the output weights
+static int32_t crelu_dot(const int16_t *input, const int16_t *weights)
+{
+#if defined(__AVX512BW__)
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i qa = _mm512_set1_epi16(NNUE_QA);
+    __m512i sum = _mm512_setzero_si512();
+
+    for (int i = 0; i < NNUE_HIDDEN; i += 32)
+    {
+        __m512i v = _mm512_loadu_si512(reinterpret_cast<const void *>(input + i));
+        __m512i w = _mm512_loadu_si512(reinterpret_cast<const void *>(weights + i));
+        v = _mm512_min_epi16(_mm512_max_epi16(v, zero), qa);
+#if defined(__AVX512VNNI__)
+        sum = _mm512_dpwssd_epi32(sum, v, w);
+#else
+        sum = _mm512_add_epi32(sum, _mm512_madd_epi16(v, w));
+#endif
+    }
+
+    return _mm512_reduce_add_epi32(sum);
+#elif defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i qa = _mm256_set1_epi16(NNUE_QA);
+    __m256i sum = _mm256_setzero_si256();
+
+    for (int i = 0; i < NNUE_HIDDEN; i += 16)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights + i));
+        v = _mm256_min_epi16(_mm256_max_epi16(v, zero), qa);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v, w));
+    }
+
+    __m128i lo = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    lo = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2)));
+    lo = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(lo);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const int16x8_t zero = vdupq_n_s16(0);
+    const int16x8_t qa = vdupq_n_s16(NNUE_QA);
+    int32x4_t sum = vdupq_n_s32(0);
+
+    for (int i = 0; i < NNUE_HIDDEN; i += 8)
+    {
+        int16x8_t v = vld1q_s16(input + i);
+        int16x8_t w = vld1q_s16(weights + i);
+        v = vminq_s16(vmaxq_s16(v, zero), qa);
+        sum = vmlal_s16(sum, vget_low_s16(v), vget_low_s16(w));
+        sum = vmlal_high_s16(sum, v, w);
+    }
+
+    return vaddvq_s32(sum);
+#else
+    int32_t sum = 0;
+    for (int i = 0; i < NNUE_HIDDEN; ++i)
+    {
+        int32_t v = std::clamp<int32_t>(input[i], 0, NNUE_QA);
+        sum += v * weights[i];
+    }
+    return sum;
+#endif
+}
+
+// Accumulator column updates; plain loops that the compiler vectorizes
+static void add_column(int16_t *acc, const int16_t *column)
+{
+    for (int i = 0; i < NNUE_HIDDEN; ++i)
+    {
+        acc[i] += column[i];
+    }
+}
+
+static void sub_column(int16_t *acc, const int16_t *column)
+{
+    for (int i = 0; i < NNUE_HIDDEN; ++i)
+    {
+        acc[i] -= column[i];
+    }
+}
+
+template <typename T>
+static bool read_array(std::ifstream &file, T *data, size_t count)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(data), count * sizeof(T)));
+}
+
+NNUEEvaluation::NNUEEvaluation() : out_bias_(0), loaded_(false) {}
+
+bool NNUEEvaluation::loadFromFile(const std::string &filename)
+{
+    loaded_ = false;
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Could not open network file: " << filename << std::endl;
+        return false;
+    }
+
+    // Header: magic, version, hidden size (all little-endian uint32)
+    uint32_t header[3];
+    if (!read_array(file, header, 3) || header[0] != NNUE_MAGIC ||
+        header[1] != NNUE_VERSION || header[2] != static_cast<uint32_t>(NNUE_HIDDEN))
+    {
+        std::cerr << "Invalid network file: " << filename << std::endl;
+        return false;
+    }
+
+    ft_weights_.resize(static_cast<size_t>(NNUE_FEATURES) * NNUE_HIDDEN);
+    ft_bias_.resize(NNUE_HIDDEN);
+    out_weights_.resize(2 * NNUE_HIDDEN);
+
+    if (!read_array(file, ft_weights_.data(), ft_weights_.size()) ||
+        !read_array(file, ft_bias_.data(), ft_bias_.size()) ||
+        !read_array(file, out_weights_.data(), out_weights_.size()) ||
+        !read_array(file, &out_bias_, 1))
+    {
+        std::cerr << "Truncated network file: " << filename << std::endl;
+        return false;
+    }
+
+    loaded_ = true;
+    std::cout << "info string Loaded NNUE network from " << filename << std::endl;
+    return true;
+}
+
+int NNUEEvaluation::evaluate(const Board &board) const
+{
+    NNUEAccumulator acc;
+    refresh(board, acc);
+    return evaluate(board, acc);
+}
+
+int NNUEEvaluation::evaluate(const Board &board, const NNUEAccumulator &acc) const
+{
+    int us = static_cast<int>(board.sideToMove());
+
+    int32_t output = crelu_dot(acc.values[us], out_weights_.data()) +
+                     crelu_dot(acc.values[us ^ 1], out_weights_.data() + NNUE_HIDDEN) +
+                     out_bias_;
+
+    return static_cast<int>(static_cast<int64_t>(output) * NNUE_SCALE / (NNUE_QA * NNUE_QB));
+}
+
+void NNUEEvaluation::refresh(const Board &board, NNUEAccumulator &acc) const
+{
+    refreshPerspective(board, Color::WHITE, acc);
+    refreshPerspective(board, Color::BLACK, acc);
+}
+
+void NNUEEvaluation::refreshPerspective(const Board &board, Color perspective, NNUEAccumulator &acc) const
+{
+    int16_t *values = acc.values[static_cast<int>(perspective)];
+    Square king_sq = board.kingSq(perspective);
+
+    std::memcpy(values, ft_bias_.data(), sizeof(int16_t) * NNUE_HIDDEN);
+
+    Bitboard occupied = board.occ();
+    while (occupied)
+    {
+        Square square = occupied.pop();
+        int feature = featureIndex(perspective, king_sq, board.at(square), square);
+        add_column(values, &ft_weights_[static_cast<size_t>(feature) * NNUE_HIDDEN]);
+    }
+}
+
+NNUEDelta NNUEEvaluation::computeDelta(const Board &board, const Move &move) const
+{
+    // Must be called before the move is made on the board
+    NNUEDelta delta;
+    Square from = move.from();
+    Square to = move.to();
+    Piece piece = board.at(from);
+    Color us = board.sideToMove();
+
+    auto removed = [&](Piece p, Square sq)
+    {
+        delta.removed_piece[delta.removed_count] = p;
+        delta.removed_sq[delta.removed_count++] = sq;
+    };
+    auto added = [&](Piece p, Square sq)
+    {
+        delta.added_piece[delta.added_count] = p;
+        delta.added_sq[delta.added_count++] = sq;
+    };
+
+    if (move.typeOf() == Move::CASTLING)
+    {
+        // chess.hpp encodes castling as king-takes-own-rook
+        bool king_side = to > from;
+        Square king_to(king_side ? chess::File::FILE_G : chess::File::FILE_C, from.rank());
+        Square rook_to(king_side ? chess::File::FILE_F : chess::File::FILE_D, from.rank());
+
+        removed(piece, from);
+        removed(board.at(to), to);
+        added(piece, king_to);
+        added(board.at(to), rook_to);
+        delta.refresh[static_cast<int>(us)] = true;
+        return delta;
+    }
+
+    if (move.typeOf() == Move::ENPASSANT)
+    {
+        removed(Piece(PieceType::PAWN, ~us), Square(to.index() ^ 8));
+    }
+    else if (board.at(to) != Piece::NONE)
+    {
+        removed(board.at(to), to);
+    }
+
+    removed(piece, from);
+    added(move.typeOf() == Move::PROMOTION ? Piece(move.promotionType(), us) : piece, to);
+
+    // Every king square is its own bucket, so king moves refresh that side
+    if (piece.type() == PieceType::KING)
+    {
+        delta.refresh[static_cast<int>(us)] = true;
+    }
+
+    return delta;
+}
+
+void NNUEEvaluation::update(const Board &board, const NNUEDelta &delta,
+                            const NNUEAccumulator &parent, NNUEAccumulator &child) const
+{
+    // Board is the position after the move
+    for (Color perspective : {Color::WHITE, Color::BLACK})
+    {
+        int p = static_cast<int>(perspective);
+
+        if (delta.refresh[p])
+        {
+            refreshPerspective(board, perspective, child);
+            continue;
+        }
+
+        int16_t *values = child.values[p];
+        Square king_sq = board.kingSq(perspective);
+        std::memcpy(values, parent.values[p], sizeof(int16_t) * NNUE_HIDDEN);
+
+        for (int i = 0; i < delta.removed_count; ++i)
+        {
+            int feature = featureIndex(perspective, king_sq, delta.removed_piece[i], delta.removed_sq[i]);
+            sub_column(values, &ft_weights_[static_cast<size_t>(feature) * NNUE_HIDDEN]);
+        }
+
+        for (int i = 0; i < delta.added_count; ++i)
+        {
+            int feature = featureIndex(perspective, king_sq, delta.added_piece[i], delta.added_sq[i]);
+            add_column(values, &ft_weights_[static_cast<size_t>(feature) * NNUE_HIDDEN]);
+        }
+    }
+}
+
+int NNUEEvaluation::featureIndex(Color perspective, Square king_sq, Piece piece, Square square)
+{
+    // Orient the board so the perspective's pieces move "up"
+    int flip = (perspective == Color::WHITE) ? 0 : 56;
+    int sq = square.index() ^ flip;
+    int king = king_sq.index() ^ flip;
+
+    // Mirror horizontally when the king is on the e-h files
+    if ((king & 7) >= 4)
+    {
+        sq ^= 7;
+        king ^= 7;
+    }
+
+    int bucket = (king >> 3) * 4 + (king & 7);
+    int relative_color = (piece.color() == perspective) ? 0 : 1;
+
+    return bucket * 768 + relative_color * 384 + static_cast<int>(piece.type()) * 64 + sq;
+}
@@ -0,0 +1,68 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include "types.h"
+#include <string>
+#include <vector>
+
+// HalfKA-style network: (32 king buckets x 768 piece features) -> 2x256 -> 1
+// King buckets mirror horizontally so the king always sits on files a-d.
+constexpr int NNUE_KING_BUCKETS = 32;
+constexpr int NNUE_FEATURES = NNUE_KING_BUCKETS * 768;
+constexpr int NNUE_HIDDEN = 256;
+
+// Quantization: accumulator in QA units, output weights in QB units
+constexpr int NNUE_QA = 255;
+constexpr int NNUE_QB = 64;
+constexpr int NNUE_SCALE = 400;
+
+// File header
+constexpr uint32_t NNUE_MAGIC = 0x4E4E5559;  // "YUNN"
+constexpr uint32_t NNUE_VERSION = 1;
+
+// First layer outputs for both perspectives
+struct alignas(64) NNUEAccumulator {
+    int16_t values[2][NNUE_HIDDEN];  // [perspective][neuron]
+};
+
+// Pieces removed and added by a move, collected before the move is made
+struct NNUEDelta {
+    int removed_count = 0;
+    int added_count = 0;
+    Piece removed_piece[2];
+    Square removed_sq[2];
+    Piece added_piece[2];
+    Square added_sq[2];
+    bool refresh[2] = {false, false};  // [perspective] own king moved
+};
+
+class NNUEEvaluation {
+public:
+    NNUEEvaluation();
+
+    bool loadFromFile(const std::string& filename);
+    bool isLoaded() const { return loaded_; }
+
+    // Full evaluation from scratch, from side to move perspective
+    int evaluate(const Board& board) const;
+    int evaluate(const Board& board, const NNUEAccumulator& acc) const;
+
+    // Accumulator maintenance, mirroring Evaluation's accumulator hooks
+    void refresh(const Board& board, NNUEAccumulator& acc) const;
+    NNUEDelta computeDelta(const Board& board, const Move& move) const;
+    void update(const Board& board, const NNUEDelta& delta,
+                const NNUEAccumulator& parent, NNUEAccumulator& child) const;
+
+private:
+    std::vector<int16_t> ft_weights_;   // [feature][hidden]
+    std::vector<int16_t> ft_bias_;      // [hidden]
+    std::vector<int16_t> out_weights_;  // [2 * hidden], side to move first
+    int32_t out_bias_;
+    bool loaded_;
+
+    void refreshPerspective(const Board& board, Color perspective, NNUEAccumulator& acc) const;
+
+    static int featureIndex(Color perspective, Square king_sq, Piece piece, Square square);
+};
+
+#endif // NNUE_H
@@ -0,0 +1,92 @@
+#include "perft.h"
+#include <iostream>
+
+PerftTable::PerftTable(int size_mb)
+{
+    size_t count = static_cast<size_t>(size_mb) * 1024 * 1024 / sizeof(Entry);
+
+    // Round down to power of 2
+    size_t power = 1;
+    while (power <= count)
+    {
+        power <<= 1;
+    }
+    table_.resize(std::max<size_t>(1, power >> 1));
+    mask_ = table_.size() - 1;
+}
+
+bool PerftTable::probe(uint64_t hash, int depth, uint64_t &nodes) const
+{
+    const Entry &entry = table_[hash & mask_];
+    if (entry.hash == hash && entry.depth == depth)
+    {
+        nodes = entry.nodes;
+        return true;
+    }
+    return false;
+}
+
+void PerftTable::store(uint64_t hash, int depth, uint64_t nodes)
+{
+    Entry &entry = table_[hash & mask_];
+    entry.hash = hash;
+    entry.depth = depth;
+    entry.nodes = nodes;
+}
+
+uint64_t perft(Board &board, int depth, PerftTable *table)
+{
+    if (depth <= 0)
+    {
+        return 1;
+    }
+
+    uint64_t nodes = 0;
+    if (table && depth > 1 && table->probe(board.hash(), depth, nodes))
+    {
+        return nodes;
+    }
+
+    chess::Movelist moves;
+    chess::movegen::legalmoves(moves, board);
+
+    // Bulk counting: the legal move count is the leaf count
+    if (depth == 1)
+    {
+        return moves.size();
+    }
+
+    for (const auto &move : moves)
+    {
+        board.makeMove(move);
+        nodes += perft(board, depth - 1, table);
+        board.unmakeMove(move);
+    }
+
+    if (table)
+    {
+        table->store(board.hash(), depth, nodes);
+    }
+
+    return nodes;
+}
+
+uint64_t perftDivide(Board &board, int depth, PerftTable *table)
+{
+    chess::Movelist moves;
+    chess::movegen::legalmoves(moves, board);
+
+    uint64_t total = 0;
+    for (const auto &move : moves)
+    {
+        board.makeMove(move);
+        uint64_t nodes = perft(board, depth - 1, table);
+        board.unmakeMove(move);
+
+        std::cout << chess::uci::moveToUci(move) << ": " << nodes << std::endl;
+        total += nodes;
+    }
+
+    std::cout << std::endl << "Nodes searched: " << total << std::endl;
+    return total;
+}
@@ -0,0 +1,32 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include "types.h"
+#include <vector>
+
+// Optional perft hash: caches subtree counts by (position, depth)
+class PerftTable {
+public:
+    explicit PerftTable(int size_mb);
+
+    bool probe(uint64_t hash, int depth, uint64_t& nodes) const;
+    void store(uint64_t hash, int depth, uint64_t nodes);
+
+private:
+    struct Entry {
+        uint64_t hash = 0;
+        uint64_t nodes = 0;
+        int depth = 0;
+    };
+
+    std::vector<Entry> table_;
+    size_t mask_;
+};
+
+// Count leaf nodes of the legal move tree; depth 1 is bulk-counted
+uint64_t perft(Board& board, int depth, PerftTable* table = nullptr);
+
+// Print the subtree count of every root move, then the total
+uint64_t perftDivide(Board& board, int depth, PerftTable* table = nullptr);
+
+#endif // PERFT_H
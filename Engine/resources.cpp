@@ -0,0 +1,96 @@
+#include "resources.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+namespace
+{
+    std::mutex resources_mutex;
+    std::map<std::string, std::weak_ptr<OpeningBook>> books;
+    std::map<std::string, std::weak_ptr<const NNUEEvaluation>> networks;
+    std::weak_ptr<Tablebase> tables;
+
+    std::mutex budget_mutex;
+    int helper_budget = 0;  // 0 = unlimited
+    int helpers_in_use = 0;
+}
+
+namespace SharedResources
+{
+    std::shared_ptr<OpeningBook> book(const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(resources_mutex);
+        if (auto shared = books[path].lock())
+        {
+            return shared;
+        }
+
+        auto loaded = std::make_shared<OpeningBook>();
+        if (path.empty() || !loaded->loadFromFile(path))
+        {
+            return nullptr;
+        }
+        books[path] = loaded;
+        return loaded;
+    }
+
+    std::shared_ptr<const NNUEEvaluation> network(const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(resources_mutex);
+        if (auto shared = networks[path].lock())
+        {
+            return shared;
+        }
+
+        auto loaded = std::make_shared<NNUEEvaluation>();
+        if (path.empty() || !loaded->loadFromFile(path))
+        {
+            return nullptr;
+        }
+        networks[path] = loaded;
+        return loaded;
+    }
+
+    std::shared_ptr<Tablebase> tablebase(const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(resources_mutex);
+        if (path.empty() || path == "<empty>")
+        {
+            return std::make_shared<Tablebase>();
+        }
+
+        auto shared = tables.lock();
+        if (shared)
+        {
+            // Re-initializing Fathom under another engine's probes is unsafe
+            return shared;
+        }
+
+        shared = std::make_shared<Tablebase>();
+        if (shared->init(path))
+        {
+            tables = shared;
+        }
+        return shared;
+    }
+
+    void setHelperBudget(int helpers)
+    {
+        std::lock_guard<std::mutex> lock(budget_mutex);
+        helper_budget = std::max(0, helpers);
+    }
+
+    int acquireHelpers(int wanted)
+    {
+        std::lock_guard<std::mutex> lock(budget_mutex);
+        int granted = helper_budget > 0 ? std::clamp(helper_budget - helpers_in_use, 0, wanted) : wanted;
+        helpers_in_use += granted;
+        return granted;
+    }
+
+    void releaseHelpers(int helpers)
+    {
+        std::lock_guard<std::mutex> lock(budget_mutex);
+        helpers_in_use -= helpers;
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef RESOURCES_H
+#define RESOURCES_H
+
+#include "book.h"
+#include "nnue.h"
+#include "tablebase.h"
+#include <memory>
+#include <string>
+
+// Read-only data shared by every ChessEngine in the process, so that the
+// sessions of a server (server.h) pay for it once: a book file is mapped
+// once, a network loaded once, and the Syzygy tables (process-wide state in
+// Fathom) initialized once. Each getter returns the copy already held by
+// another engine when there is one, and nullptr when path can't be loaded.
+namespace SharedResources {
+    std::shared_ptr<OpeningBook> book(const std::string& path);
+    std::shared_ptr<const NNUEEvaluation> network(const std::string& path);
+
+    // Never null; without tables (path empty or failing) the result has
+    // none. Fathom holds one set per process, so while another engine uses
+    // tables from a different path, those are returned instead.
+    std::shared_ptr<Tablebase> tablebase(const std::string& path);
+
+    // Search threads beyond each search's main thread, over all engines.
+    // 0 (the default) leaves them unlimited.
+    void setHelperBudget(int helpers);
+    // Up to wanted helpers, fewer when other searches hold the budget
+    int acquireHelpers(int wanted);
+    void releaseHelpers(int helpers);
+}
+
+#endif // RESOURCES_H
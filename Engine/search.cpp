@@ -1,14 +1,92 @@
 #include "search.h"
+#include "movepick.h"
+#include "see.h"
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstring>
 
+// Late move reductions by [depth][move number], growing with the log of both
+static const auto LMR_TABLE = []
+{
+    std::array<std::array<int, 64>, MAX_DEPTH + 1> table{};
+    for (int d = 1; d <= MAX_DEPTH; ++d)
+    {
+        for (int m = 1; m < 64; ++m)
+        {
+            table[d][m] = static_cast<int>(0.75 + std::log(d) * std::log(m) / 1.75);
+        }
+    }
+    return table;
+}();
+
+bool SearchBoard::isRepetitionDraw(int ply) const
+{
+    const int size = static_cast<int>(prev_states_.size());
+    int count = 0;
+
+    // Same side to move every second entry, back to the last capture or pawn move
+    for (int i = size - 2; i >= 0 && i >= size - hfm_ - 1; i -= 2)
+    {
+        if (prev_states_[i].hash == key_ && (size - i <= ply || ++count == 2))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 Search::Search(TranspositionTable &tt, Evaluation &eval)
     : tt_(&tt), eval_(&eval)
 {
+    for (StackEntry &entry : stack_)
+    {
+        entry.excluded = Move::NO_MOVE;
+        entry.double_extensions = 0;
+    }
     clearHistory();
 }
 
-SearchResult Search::searchRoot(const Board &board, int depth, SearchInfo &info)
+void Search::initRootMoves(const Board &board, const std::vector<Move> &allowed)
+{
+    chess::Movelist moves;
+    chess::movegen::legalmoves(moves, board);
+
+    // Initial order: TT move first, then the usual move ordering
+    TTEntry tt_entry;
+    Move tt_move = tt_->probe(board.hash(), tt_entry) ? tt_entry.move : Move(Move::NO_MOVE);
+    orderMoves(moves, board, tt_move, 0);
+
+    root_moves_.clear();
+    root_hash_ = board.hash();
+    for (const auto &move : moves)
+    {
+        if (allowed.empty() || std::find(allowed.begin(), allowed.end(), move) != allowed.end())
+        {
+            root_moves_.emplace_back(move);
+        }
+    }
+
+    // None of the allowed moves is legal here: search them all
+    if (root_moves_.empty())
+    {
+        for (const auto &move : moves)
+        {
+            root_moves_.emplace_back(move);
+        }
+    }
+}
+
+void Search::newIteration()
+{
+    for (auto &root_move : root_moves_)
+    {
+        root_move.previous_score = root_move.score;
+    }
+}
+
+SearchResult Search::searchRoot(const Board &board, int depth, SearchInfo &info, int alpha, int beta, int pv_index)
 {
     SearchResult result;
     result.best_move = Move::NO_MOVE;
@@ -16,51 +94,68 @@ SearchResult Search::searchRoot(const Board &board, int depth, SearchInfo &info)
     result.nodes = 0;
     result.pv.clear();
 
-    Board board_copy = board;
-    chess::Movelist moves;
-    chess::movegen::legalmoves(moves, board_copy);
+    SearchBoard &root = root_board_;
+    root.set(board);
+    if (root_moves_.empty() || root_hash_ != board.hash())
+    {
+        initRootMoves(root, {});
+    }
 
-    if (moves.empty())
+    if (root_moves_.empty())
     {
         // Checkmate or stalemate
-        result.score = board_copy.inCheck() ? -MATE_VALUE + 0 : 0;
+        result.score = root.inCheck() ? -MATE_VALUE + 0 : 0;
         return result;
     }
 
-    // Order root moves
-    orderMoves(moves, board_copy, Move::NO_MOVE, 0);
+    initEvaluation(root);
+    root_depth_ = depth;
+    stack_[0].static_eval = VALUE_NONE;
+    stack_[0].double_extensions = stack_[1].double_extensions = 0;
 
-    int alpha = -MATE_VALUE;
-    int beta = MATE_VALUE;
+    const int original_alpha = alpha;
     bool pv_found = false;
+    [[maybe_unused]] uint64_t start_nodes = info.nodes;
+
+    for (size_t i = pv_index; i < root_moves_.size(); ++i)
+    {
+        root_moves_[i].score = -MATE_VALUE;
+        root_moves_[i].nodes = 0;
+    }
 
-    for (size_t i = 0; i < moves.size() && !info.should_stop(); ++i)
+    for (size_t i = pv_index; i < root_moves_.size() && !info.should_stop(); ++i)
     {
-        Move move = moves[i];
-        board_copy.makeMove(move);
+        RootMove &root_move = root_moves_[i];
+        Move move = root_move.move;
+        uint64_t move_start_nodes = info.nodes;
+        if (root_move_callback_)
+        {
+            root_move_callback_(depth, move, static_cast<int>(i) + 1);
+        }
+        pushStack(root, move, 0);
+        makeMove(root, move, 0);
 
         int score;
-        PVLine pv;
 
-        if (!pv_found)
+        if (i == static_cast<size_t>(pv_index))
         {
             // First move - search with full window
-            score = -search(board_copy, depth - 1, 1, -beta, -alpha, pv, info);
+            score = -search(root, depth - 1, 1, -beta, -alpha, info);
         }
         else
         {
             // Try null window search first
-            score = -search(board_copy, depth - 1, 1, -alpha - 1, -alpha, pv, info);
+            score = -search(root, depth - 1, 1, -alpha - 1, -alpha, info);
 
             if (score > alpha && score < beta)
             {
                 // Re-search with full window
-                pv.clear();
-                score = -search(board_copy, depth - 1, 1, -beta, -alpha, pv, info);
+                score = -search(root, depth - 1, 1, -beta, -alpha, info);
             }
         }
 
-        board_copy.unmakeMove(move);
+        unmakeMove(root, move);
+        root_move.nodes = info.nodes - move_start_nodes;
 
         if (info.should_stop())
         {
@@ -74,35 +169,65 @@ SearchResult Search::searchRoot(const Board &board, int depth, SearchInfo &info)
             result.score = score;
 
             // Update PV
-            result.pv.clear();
-            result.pv.push(move);
-            for (int j = 0; j < pv.count; ++j)
+            updatePV(move, 0);
+            root_move.score = score;
+            root_move.pv.clear();
+            for (int j = 0; j < pv_length_[0]; ++j)
             {
-                result.pv.push(pv.moves[j]);
+                root_move.pv.push(pv_table_[0][j]);
             }
+            result.pv = root_move.pv;
 
             pv_found = true;
 
-            // Update transposition table
-            tt_->store(board.hash(), depth, score, TT_EXACT, move);
+            // Update transposition table; later MultiPV lines exclude the best move
+            if (pv_index == 0)
+            {
+                tt_->store(board.hash(), depth, score, score >= beta ? TT_LOWER : TT_EXACT, move);
+            }
+
+            // Fail high against an aspiration window
+            if (score >= beta)
+            {
+                break;
+            }
         }
     }
 
+    if (pv_found && !info.should_stop())
+    {
+        // Moves that raised alpha by score; the rest had to be refuted, and
+        // the ones that took the most effort are the likeliest to improve
+        std::stable_sort(root_moves_.begin() + pv_index, root_moves_.end(),
+                         [](const RootMove &a, const RootMove &b)
+                         { return a.score != b.score ? a.score > b.score : a.nodes > b.nodes; });
+    }
+
+    // Fail low: every move scored at or below alpha
+    if (!pv_found && !info.should_stop())
+    {
+        result.score = original_alpha;
+    }
+
     result.nodes = info.nodes;
+    SEARCH_STAT(stats_.depth_nodes[std::min(depth, MAX_DEPTH)] += result.nodes - start_nodes);
     return result;
 }
 
-int Search::search(Board &board, int depth, int ply, int alpha, int beta,
-                   PVLine &pv, SearchInfo &info, bool null_move_allowed)
+int Search::search(SearchBoard &board, int depth, int ply, int alpha, int beta,
+                   SearchInfo &info, bool null_move_allowed)
 {
-    pv.clear();
+    pv_length_[ply] = ply;
 
     if (info.should_stop())
     {
         return 0;
     }
 
-    info.nodes++;
+    info.count_node();
+    info.check_time();
+    info.update_seldepth(ply);
+    SEARCH_STAT(stats_.nodes++);
 
     // Mate distance pruning
     mateDistancePruning(alpha, beta, ply);
@@ -112,13 +237,24 @@ int Search::search(Board &board, int depth, int ply, int alpha, int beta,
     }
 
     // Check for draw by repetition or 50-move rule
-    if (ply > 0 && (board.isRepetition() || board.isHalfMoveDraw()))
+    if (ply > 0 && (board.isRepetitionDraw(ply) || board.isHalfMoveDraw()))
     {
         return 0;
     }
 
-    bool in_check = board.inCheck();
+    AttackInfo &attacks = attack_info_[ply];
+    attacks.init(board);
+
+    if (ply >= MAX_PLY)
+    {
+        return evaluatePosition(board, ply);
+    }
+
+    bool in_check = attacks.inCheck();
     bool pv_node = (beta - alpha > 1);
+    // Set while verifying that the TT move is singular: the node is searched
+    // without it, so its result must neither come from nor go to the TT
+    const Move excluded = stack_[ply].excluded;
 
     // Quiescence search at leaf nodes
     if (depth <= 0)
@@ -128,125 +264,291 @@ int Search::search(Board &board, int depth, int ply, int alpha, int beta,
 
     // Transposition table lookup
     Move hash_move = Move::NO_MOVE;
-    TTEntry *entry = tt_->probe(board.hash());
-    if (entry && entry->hash == board.hash())
+    TTEntry entry;
+    SEARCH_STAT(stats_.tt_probes++);
+    bool tt_hit = tt_->probe(board.hash(), entry);
+    if (tt_hit)
     {
-        hash_move = entry->move;
+        hash_move = entry.move;
+        SEARCH_STAT(stats_.tt_hits++);
 
-        if (entry->depth >= depth && !pv_node)
+        if (entry.depth >= depth && !pv_node && excluded == Move::NO_MOVE)
         {
-            int tt_score = entry->score;
+            int tt_score = entry.score;
 
-            // Adjust mate scores
-            if (tt_score > MATE_IN_MAX_PLY)
+            // Adjust mate and tablebase scores
+            if (tt_score > TB_WIN_IN_MAX_PLY)
             {
                 tt_score -= ply;
             }
-            else if (tt_score < -MATE_IN_MAX_PLY)
+            else if (tt_score < -TB_WIN_IN_MAX_PLY)
             {
                 tt_score += ply;
             }
 
-            switch (entry->flag)
+            if (entry.flag == TT_EXACT || (entry.flag == TT_LOWER && tt_score >= beta) ||
+                (entry.flag == TT_UPPER && tt_score <= alpha))
             {
-            case TT_EXACT:
+                SEARCH_STAT(stats_.tt_cutoffs++);
                 return tt_score;
-            case TT_LOWER:
-                if (tt_score >= beta)
-                    return tt_score;
-                break;
-            case TT_UPPER:
-                if (tt_score <= alpha)
-                    return tt_score;
-                break;
             }
         }
     }
 
+    // Tablebase probe: exact WDL knowledge bounds the score
+    int best_score = -MATE_VALUE;
+    int max_score = MATE_VALUE;
+    if (tb_ && ply > 0 && excluded == Move::NO_MOVE && tb_->canProbeWDL(board))
+    {
+        int wdl = tb_->probeWDL(board);
+        if (wdl >= 0)
+        {
+            info.tbhits++;
+
+            int tb_score = 0;
+            TTFlag tb_flag = TT_EXACT;
+            if (wdl == WDL_WIN)
+            {
+                tb_score = TB_WIN_SCORE - ply;
+                tb_flag = TT_LOWER;
+            }
+            else if (wdl == WDL_LOSS)
+            {
+                tb_score = -TB_WIN_SCORE + ply;
+                tb_flag = TT_UPPER;
+            }
+
+            if (tb_flag == TT_EXACT || (tb_flag == TT_LOWER ? tb_score >= beta : tb_score <= alpha))
+            {
+                // Deeper than any search will reach here, so it is kept
+                int store_score = tb_score > 0 ? tb_score + ply : (tb_score < 0 ? tb_score - ply : 0);
+                tt_->store(board.hash(), std::min(depth + 6, MAX_DEPTH), store_score, tb_flag, Move::NO_MOVE);
+                return tb_score;
+            }
+
+            // In PV nodes keep searching for the exact score within the bound
+            if (pv_node)
+            {
+                if (tb_flag == TT_LOWER)
+                {
+                    best_score = tb_score;
+                    alpha = std::max(alpha, tb_score);
+                }
+                else
+                {
+                    max_score = tb_score;
+                }
+            }
+        }
+    }
+
+    // Static evaluation, reused from the TT when it has one. The TT score
+    // bound refines it for pruning; improving compares with our last move.
+    int static_eval = VALUE_NONE;
+    int eval = VALUE_NONE;
+    bool improving = false;
+    if (!in_check)
+    {
+        static_eval = (tt_hit && entry.eval != VALUE_NONE) ? entry.eval : evaluatePosition(board, ply);
+        eval = static_eval;
+
+        if (tt_hit && std::abs(entry.score) < TB_WIN_IN_MAX_PLY &&
+            (entry.flag == (entry.score > eval ? TT_LOWER : TT_UPPER) || entry.flag == TT_EXACT))
+        {
+            eval = entry.score;
+        }
+
+        if (ply >= 2 && stack_[ply - 2].static_eval != VALUE_NONE)
+        {
+            improving = static_eval > stack_[ply - 2].static_eval;
+        }
+        else if (ply >= 4 && stack_[ply - 4].static_eval != VALUE_NONE)
+        {
+            improving = static_eval > stack_[ply - 4].static_eval;
+        }
+        else
+        {
+            improving = true;
+        }
+    }
+    stack_[ply].static_eval = static_eval;
+
+    // Reverse futility pruning: far enough above beta that a quiet search
+    // is unlikely to bring it back down
+    if (!pv_node && !in_check && excluded == Move::NO_MOVE && depth <= RFP_DEPTH && std::abs(beta) < TB_WIN_IN_MAX_PLY &&
+        eval - RFP_MARGIN * (depth - improving) >= beta)
+    {
+        return eval;
+    }
+
     // Null move pruning
-    if (null_move_allowed && !pv_node && !in_check && depth >= 3 && canDoNullMove(board))
+    if (null_move_allowed && !pv_node && !in_check && excluded == Move::NO_MOVE && depth >= 3 && eval >= beta &&
+        canDoNullMove(board))
     {
         int R = 3 + depth / 6; // Adaptive reduction
 
-        board.makeNullMove();
-        int null_score = -search(board, depth - R - 1, ply + 1, -beta, -beta + 1, pv, info, false);
-        board.unmakeNullMove();
+        SEARCH_STAT(stats_.null_tries++);
+        stack_[ply].move = Move::NO_MOVE;
+        stack_[ply].piece = -1;
+        stack_[ply].cont = nullptr;
+        stack_[ply + 1].double_extensions = stack_[ply].double_extensions;
+        makeNullMove(board, ply);
+        int null_score = -search(board, depth - R - 1, ply + 1, -beta, -beta + 1, info, false);
+        unmakeNullMove(board);
 
         if (null_score >= beta)
         {
+            SEARCH_STAT(stats_.null_cutoffs++);
             return null_score;
         }
     }
 
-    // Generate moves
-    chess::Movelist moves;
-    chess::movegen::legalmoves(moves, board);
-
-    if (moves.empty())
+    // Countermove: the last reply that refuted the opponent's previous move
+    Move counter_move = Move::NO_MOVE;
+    if (ply > 0 && stack_[ply - 1].piece >= 0)
     {
-        return in_check ? -MATE_VALUE + ply : 0;
+        counter_move = history_.counter_moves[stack_[ply - 1].piece][stack_[ply - 1].move.to().index()];
     }
 
-    // Order moves
-    orderMoves(moves, board, hash_move, ply);
+    // Moves are generated lazily in stages by the picker
+    attacks.computeCheckInfo(board);
+    const PieceToHistory *cont[2];
+    continuationTables(ply, cont);
+    MovePicker picker(board, hash_move, killer_moves_[ply], counter_move, history_, cont);
 
-    int best_score = -MATE_VALUE;
     Move best_move = Move::NO_MOVE;
     TTFlag flag = TT_UPPER;
     bool legal_move_found = false;
+    Move move;
 
-    for (size_t i = 0; i < moves.size() && !info.should_stop(); ++i)
+    // Moves searched so far, penalized when a later move cuts off
+    Move quiets_tried[64];
+    Move captures_tried[32];
+    int quiet_count = 0;
+    int capture_count = 0;
+
+    for (int i = 0; (move = picker.next()) != Move::NO_MOVE && !info.should_stop(); ++i)
     {
-        Move move = moves[i];
+        if (move == excluded)
+        {
+            continue;
+        }
 
-        // Make move
-        board.makeMove(move);
-        legal_move_found = true;
+        bool capture = board.isCapture(move);
+        bool gives_check = attacks.givesCheck(board, move);
+
+        // SEE pruning: at shallow depth skip moves that lose too much material,
+        // as long as we already have a move that avoids getting mated
+        if (!pv_node && !in_check && i > 0 && depth <= SEE_PRUNE_DEPTH && best_score > -TB_WIN_IN_MAX_PLY)
+        {
+            int threshold = capture ? -SEE_CAPTURE_MARGIN * depth * depth : -SEE_QUIET_MARGIN * depth;
+            if (!see(board, move, threshold))
+            {
+                continue;
+            }
+        }
+
+        int history = capture ? 0 : quietHistory(board, move, ply);
+
+        // Quiet move pruning once a move has been searched and we are not
+        // being mated: late moves, then moves that can't lift eval to alpha.
+        // Checks are kept, they are what shallow mates are made of.
+        if (!pv_node && !in_check && !capture && move.typeOf() != Move::PROMOTION &&
+            best_score > -TB_WIN_IN_MAX_PLY && !gives_check)
+        {
+            if (depth <= LMP_DEPTH && quiet_count >= lmpLimit(depth, improving))
+            {
+                continue;
+            }
+
+            if (depth <= FUTILITY_DEPTH && eval + FUTILITY_BASE + FUTILITY_MARGIN * depth <= alpha)
+            {
+                continue;
+            }
+        }
 
-        // Extensions
-        int extension = getExtension(move, board, in_check);
+        // Extensions, while the line is short enough to afford them
+        int extension = 0;
+        if (ply < 2 * root_depth_)
+        {
+            // Singular extension: the TT move is the only good one when every
+            // other move fails low against a bound somewhat below its score
+            if (move == hash_move && excluded == Move::NO_MOVE && ply > 0 && depth >= SINGULAR_DEPTH &&
+                entry.depth >= depth - 3 && entry.flag != TT_UPPER && std::abs(entry.score) < TB_WIN_IN_MAX_PLY)
+            {
+                int singular_beta = entry.score - SINGULAR_MARGIN * depth;
+                SEARCH_STAT(stats_.singular_searches++);
+                stack_[ply].excluded = move;
+                int singular_score = search(board, (depth - 1) / 2, ply, singular_beta - 1, singular_beta, info, false);
+                stack_[ply].excluded = Move::NO_MOVE;
+                pv_length_[ply] = ply;
+
+                if (singular_score < singular_beta)
+                {
+                    SEARCH_STAT(stats_.singular_extensions++);
+                    bool double_extend = !pv_node && singular_score < singular_beta - DOUBLE_EXTENSION_MARGIN &&
+                                         stack_[ply].double_extensions < MAX_DOUBLE_EXTENSIONS;
+                    extension = double_extend ? 2 : 1;
+                }
+                else if (singular_beta >= beta)
+                {
+                    // Multi-cut: another move beats beta as well
+                    SEARCH_STAT(stats_.multi_cuts++);
+                    return singular_beta;
+                }
+            }
+            else
+            {
+                extension = getExtension(board, move, gives_check);
+            }
+        }
         int new_depth = depth - 1 + extension;
+        stack_[ply + 1].double_extensions = stack_[ply].double_extensions + (extension >= 2);
+
+        // Make move
+        pushStack(board, move, ply);
+        makeMove(board, move, ply);
+        legal_move_found = true;
 
         int score;
-        PVLine child_pv;
 
-        // Late Move Reductions (LMR)
-        if (i >= 4 && depth >= 3 && !in_check && !board.inCheck() &&
-            move.typeOf() == Move::NORMAL && !board.isCapture(move))
+        // Late Move Reductions (LMR): quiet moves and captures that lose material
+        if (i >= 3 && depth >= 3 && !in_check && !gives_check &&
+            move.typeOf() == Move::NORMAL && (!capture || picker.isBadCaptureStage()))
         {
 
-            int reduction = getReduction(move, depth, static_cast<int>(i), pv_node);
+            int reduction = std::clamp(getReduction(depth, i, pv_node, history), 0, new_depth - 1);
 
             // Search with reduction
-            score = -search(board, new_depth - reduction, ply + 1, -alpha - 1, -alpha,
-                            child_pv, info);
+            SEARCH_STAT(stats_.lmr_searches++);
+            score = -search(board, new_depth - reduction, ply + 1, -alpha - 1, -alpha, info);
 
             // If LMR search fails high, re-search without reduction
             if (score > alpha)
             {
-                score = -search(board, new_depth, ply + 1, -alpha - 1, -alpha,
-                                child_pv, info);
+                SEARCH_STAT(stats_.lmr_researches++);
+                score = -search(board, new_depth, ply + 1, -alpha - 1, -alpha, info);
             }
         }
-        else if (i == 0 || pv_node)
+        else if (i == 0)
         {
             // First move or PV node - search with full window
-            score = -search(board, new_depth, ply + 1, -beta, -alpha, child_pv, info);
+            score = -search(board, new_depth, ply + 1, -beta, -alpha, info);
         }
         else
         {
             // Try zero-window search first
-            score = -search(board, new_depth, ply + 1, -alpha - 1, -alpha, child_pv, info);
+            score = -search(board, new_depth, ply + 1, -alpha - 1, -alpha, info);
 
             // If it fails high, re-search with full window
             if (score > alpha && score < beta)
             {
-                child_pv.clear();
-                score = -search(board, new_depth, ply + 1, -beta, -alpha, child_pv, info);
+                SEARCH_STAT(stats_.pvs_researches++);
+                score = -search(board, new_depth, ply + 1, -beta, -alpha, info);
             }
         }
 
-        board.unmakeMove(move);
+        unmakeMove(board, move);
 
         if (info.should_stop())
         {
@@ -263,22 +565,23 @@ int Search::search(Board &board, int depth, int ply, int alpha, int beta,
                 alpha = score;
                 flag = TT_EXACT;
 
-                // Update PV
-                pv.clear();
-                pv.push(move);
-                for (int j = 0; j < child_pv.count; ++j)
-                {
-                    pv.push(child_pv.moves[j]);
-                }
+                updatePV(move, ply);
 
                 if (score >= beta)
                 {
                     flag = TT_LOWER;
+                    SEARCH_STAT(stats_.fail_highs++);
+                    SEARCH_STAT(stats_.fail_highs_first += (i == 0));
 
-                    // Update history and killer moves for quiet moves
-                    if (!board.isCapture(move))
+                    // Reward the cutoff move, penalize the moves tried before it
+                    if (capture)
                     {
-                        updateHistory(move, board.sideToMove(), depth);
+                        updateCaptureStats(board, move, depth, captures_tried, capture_count);
+                    }
+                    else
+                    {
+                        updateQuietStats(board, move, ply, depth, quiets_tried, quiet_count);
+                        updateCaptureStats(board, Move::NO_MOVE, depth, captures_tried, capture_count);
                         updateKillers(move, ply);
                     }
 
@@ -286,25 +589,52 @@ int Search::search(Board &board, int depth, int ply, int alpha, int beta,
                 }
             }
         }
+
+        if (capture && capture_count < 32)
+        {
+            captures_tried[capture_count++] = move;
+        }
+        else if (!capture && quiet_count < 64)
+        {
+            quiets_tried[quiet_count++] = move;
+        }
+    }
+
+    // An interrupted node has an incomplete score; never store it
+    if (info.should_stop())
+    {
+        return 0;
     }
 
     if (!legal_move_found)
     {
+        // Without the excluded move there may be nothing left to play
+        if (excluded != Move::NO_MOVE)
+        {
+            return alpha;
+        }
         return in_check ? -MATE_VALUE + ply : 0;
     }
 
+    best_score = std::min(best_score, max_score);
+
+    if (excluded != Move::NO_MOVE)
+    {
+        return best_score;
+    }
+
     // Store in transposition table
     int store_score = best_score;
-    if (store_score > MATE_IN_MAX_PLY)
+    if (store_score > TB_WIN_IN_MAX_PLY)
     {
         store_score += ply;
     }
-    else if (store_score < -MATE_IN_MAX_PLY)
+    else if (store_score < -TB_WIN_IN_MAX_PLY)
     {
         store_score -= ply;
     }
 
-    tt_->store(board.hash(), depth, store_score, flag, best_move);
+    tt_->store(board.hash(), depth, store_score, flag, best_move, static_eval);
 
     return best_score;
 }
@@ -316,10 +646,21 @@ int Search::quiescence(Board &board, int ply, int alpha, int beta, SearchInfo &i
         return 0;
     }
 
-    info.nodes++;
+    info.count_node();
+    info.check_time();
+    info.update_seldepth(ply);
+    SEARCH_STAT(stats_.qnodes++);
 
     // Stand pat
-    int stand_pat = eval_->evaluate(board);
+    AttackInfo &attacks = attack_info_[ply];
+    attacks.init(board);
+    bool in_check = attacks.inCheck();
+    int stand_pat = evaluatePosition(board, ply);
+
+    if (ply >= MAX_PLY)
+    {
+        return stand_pat;
+    }
 
     if (stand_pat >= beta)
     {
@@ -331,59 +672,41 @@ int Search::quiescence(Board &board, int ply, int alpha, int beta, SearchInfo &i
         alpha = stand_pat;
     }
 
-    // Generate capturing moves
-    chess::Movelist moves;
-    chess::movegen::legalmoves<chess::movegen::MoveGenType::CAPTURE>(moves, board);
-
-    // Order captures by MVV-LVA
-    std::sort(moves.begin(), moves.end(), [&](const Move &a, const Move &b)
-              { return getMoveScore(a, board, Move::NO_MOVE, ply) >
-                       getMoveScore(b, board, Move::NO_MOVE, ply); });
+    // Captures in MVV-LVA order
+    MovePicker picker(board, history_);
+    Move move;
 
-    for (const auto &move : moves)
+    while ((move = picker.next()) != Move::NO_MOVE)
     {
         if (info.should_stop())
         {
             break;
         }
 
-        // Delta pruning - don't consider captures that can't improve alpha
-        if (!board.inCheck())
+        if (!in_check)
         {
-            int captured_value = 0;
-            if (board.at(move.to()) != Piece::NONE)
+            // Delta pruning - don't consider captures that can't improve alpha
+            int captured_value = SEE_VALUES[static_cast<int>(board.at<PieceType>(move.to()))];
+            if (move.typeOf() == Move::PROMOTION)
             {
-                switch (board.at(move.to()).type())
-                {
-                case static_cast<int>(chess::PieceType::PAWN):
-                    captured_value = 100;
-                    break;
-                case static_cast<int>(chess::PieceType::KNIGHT):
-                    captured_value = 320;
-                    break;
-                case static_cast<int>(chess::PieceType::BISHOP):
-                    captured_value = 330;
-                    break;
-                case static_cast<int>(chess::PieceType::ROOK):
-                    captured_value = 500;
-                    break;
-                case static_cast<int>(chess::PieceType::QUEEN):
-                    captured_value = 900;
-                    break;
-                default:
-                    break;
-                }
+                captured_value += SEE_VALUES[static_cast<int>(move.promotionType())] - SEE_VALUES[0];
+            }
+
+            if (stand_pat + captured_value + QS_DELTA_MARGIN < alpha)
+            {
+                continue;
             }
 
-            if (stand_pat + captured_value + 200 < alpha)
+            // Captures that lose material in the exchange can't either
+            if (!see(board, move, 0))
             {
                 continue;
             }
         }
 
-        board.makeMove(move);
+        makeMove(board, move, ply);
         int score = -quiescence(board, ply + 1, -beta, -alpha, info);
-        board.unmakeMove(move);
+        unmakeMove(board, move);
 
         if (score >= beta)
         {
@@ -399,6 +722,77 @@ int Search::quiescence(Board &board, int ply, int alpha, int beta, SearchInfo &i
     return alpha;
 }
 
+void Search::makeMove(Board &board, const Move &move, int ply)
+{
+    if (nnue_)
+    {
+        NNUEDelta delta = nnue_->computeDelta(board, move);
+        board.makeMove(move);
+        nnue_->update(board, delta, nnue_stack_[ply], nnue_stack_[ply + 1]);
+        return;
+    }
+
+    eval_stack_[ply + 1] = eval_stack_[ply];
+    eval_->updateAccumulator(board, move, eval_stack_[ply + 1]);
+    board.makeMove(move);
+}
+
+void Search::unmakeMove(Board &board, const Move &move)
+{
+    // The accumulator for the parent ply is still intact on the stack
+    board.unmakeMove(move);
+}
+
+void Search::makeNullMove(Board &board, int ply)
+{
+    if (nnue_)
+    {
+        nnue_stack_[ply + 1] = nnue_stack_[ply];
+    }
+    else
+    {
+        eval_stack_[ply + 1] = eval_stack_[ply];
+    }
+    board.makeNullMove();
+}
+
+void Search::unmakeNullMove(Board &board)
+{
+    board.unmakeNullMove();
+}
+
+void Search::initEvaluation(const Board &board)
+{
+    if (nnue_)
+    {
+        nnue_->refresh(board, nnue_stack_[0]);
+    }
+    else
+    {
+        eval_->initAccumulator(board, eval_stack_[0]);
+    }
+}
+
+void Search::updatePV(const Move &move, int ply)
+{
+    // This node's line is the move followed by the line of the child below
+    pv_table_[ply][ply] = move;
+    for (int j = ply + 1; j < pv_length_[ply + 1]; ++j)
+    {
+        pv_table_[ply][j] = pv_table_[ply + 1][j];
+    }
+    pv_length_[ply] = pv_length_[ply + 1];
+}
+
+int Search::evaluatePosition(const Board &board, int ply)
+{
+    if (nnue_)
+    {
+        return nnue_->evaluate(board, nnue_stack_[ply]);
+    }
+    return eval_->evaluate(board, eval_stack_[ply], &pawn_table_, &attack_info_[ply]);
+}
+
 void Search::orderMoves(chess::Movelist &moves, const Board &board, Move hash_move, int ply)
 {
     std::sort(moves.begin(), moves.end(), [&](const Move &a, const Move &b)
@@ -423,7 +817,10 @@ int Search::getMoveScore(const Move &move, const Board &board, Move hash_move, i
 
         if (victim != PieceType::NONE && attacker != PieceType::NONE)
         {
-            score = 10000 + MVV_LVA[static_cast<int>(victim)][static_cast<int>(attacker)];
+            score = MVV_LVA[static_cast<int>(victim)][static_cast<int>(attacker)];
+
+            // Losing captures go after the quiet moves
+            score += see(board, move, 0) ? 10000 : -1000000;
         }
     }
     // Killer moves
@@ -435,25 +832,17 @@ int Search::getMoveScore(const Move &move, const Board &board, Move hash_move, i
     // History heuristic
     else
     {
-        int from = move.from().index();
-        int to = move.to().index();
-        int color = static_cast<int>(board.sideToMove());
-        score = history_[color][from][to];
+        score = quietHistory(board, move, ply);
     }
 
     return score;
 }
 
-int Search::getExtension(const Move &move, const Board &board, bool in_check)
+int Search::getExtension(const Board &board, const Move &move, bool gives_check)
 {
-    // Check extension
-    if (board.inCheck())
-    {
-        return 1;
-    }
-
-    // Promotion extension
-    if (move.typeOf() == Move::PROMOTION)
+    // Checks and promotions, unless the piece is simply lost
+    if ((move.typeOf() == Move::PROMOTION || gives_check) &&
+        see(board, move, 0))
     {
         return 1;
     }
@@ -461,16 +850,18 @@ int Search::getExtension(const Move &move, const Board &board, bool in_check)
     return 0;
 }
 
-int Search::getReduction(const Move &move, int depth, int move_count, bool pv_node)
+int Search::getReduction(int depth, int move_count, bool pv_node, int history)
 {
+    int reduction = LMR_TABLE[std::min(depth, MAX_DEPTH)][std::min(move_count, 63)];
+
+    // Reduce less in PV nodes and for moves with a good history
     if (pv_node)
     {
-        return std::max(0, depth / 6 + move_count / 8 - 1);
-    }
-    else
-    {
-        return std::max(0, depth / 4 + move_count / 6);
+        reduction -= 1;
     }
+    reduction -= history / 8192;
+
+    return reduction;
 }
 
 bool Search::canDoNullMove(const Board &board)
@@ -490,24 +881,59 @@ void Search::mateDistancePruning(int &alpha, int &beta, int ply)
         beta = mate_beta;
 }
 
-void Search::updateHistory(const Move &move, Color color, int depth)
+void Search::updateQuietStats(const Board &board, const Move &move, int ply, int depth,
+                              const Move *quiets, int quiet_count)
 {
-    int from = move.from().index();
-    int to = move.to().index();
-    int color_idx = static_cast<int>(color);
+    int color = static_cast<int>(board.sideToMove());
+    int bonus = historyBonus(depth);
+    PieceToHistory *cont[2] = {ply >= 1 ? stack_[ply - 1].cont : nullptr,
+                               ply >= 2 ? stack_[ply - 2].cont : nullptr};
 
-    history_[color_idx][from][to] += depth * depth;
-
-    // Prevent overflow
-    if (history_[color_idx][from][to] > 10000)
+    auto update = [&](const Move &m, int amount)
     {
-        for (int i = 0; i < 64; ++i)
+        int piece = static_cast<int>(board.at(m.from()));
+        int to = m.to().index();
+        updateGravity(history_.butterfly[color][m.from().index()][to], amount);
+        for (PieceToHistory *table : cont)
         {
-            for (int j = 0; j < 64; ++j)
+            if (table)
             {
-                history_[color_idx][i][j] /= 2;
+                updateGravity((*table)[piece][to], amount);
             }
         }
+    };
+
+    update(move, bonus);
+    for (int i = 0; i < quiet_count; ++i)
+    {
+        update(quiets[i], -bonus);
+    }
+
+    if (ply > 0 && stack_[ply - 1].piece >= 0)
+    {
+        history_.counter_moves[stack_[ply - 1].piece][stack_[ply - 1].move.to().index()] = move;
+    }
+}
+
+void Search::updateCaptureStats(const Board &board, const Move &move, int depth,
+                                const Move *captures, int capture_count)
+{
+    int bonus = historyBonus(depth);
+
+    auto update = [&](const Move &m, int amount)
+    {
+        int piece = static_cast<int>(board.at(m.from()));
+        auto victim = m.typeOf() == Move::ENPASSANT ? PieceType(PieceType::PAWN) : board.at(m.to()).type();
+        updateGravity(history_.capture[piece][m.to().index()][static_cast<int>(victim)], amount);
+    };
+
+    if (move != Move::NO_MOVE)
+    {
+        update(move, bonus);
+    }
+    for (int i = 0; i < capture_count; ++i)
+    {
+        update(captures[i], -bonus);
     }
 }
 
@@ -525,6 +951,38 @@ void Search::updateKillers(const Move &move, int ply)
 
 void Search::clearHistory()
 {
-    std::memset(history_, 0, sizeof(history_));
+    history_.clear();
     std::memset(killer_moves_, 0, sizeof(killer_moves_));
+}
+
+void Search::pushStack(const Board &board, const Move &move, int ply)
+{
+    int piece = static_cast<int>(board.at(move.from()));
+    stack_[ply].move = move;
+    stack_[ply].piece = piece;
+    stack_[ply].cont = &history_.continuation[piece][move.to().index()];
+}
+
+void Search::continuationTables(int ply, const PieceToHistory *cont[2]) const
+{
+    cont[0] = ply >= 1 ? stack_[ply - 1].cont : nullptr;
+    cont[1] = ply >= 2 ? stack_[ply - 2].cont : nullptr;
+}
+
+int Search::quietHistory(const Board &board, const Move &move, int ply) const
+{
+    int piece = static_cast<int>(board.at(move.from()));
+    int to = move.to().index();
+    int score = history_.butterfly[static_cast<int>(board.sideToMove())][move.from().index()][to];
+
+    const PieceToHistory *cont[2];
+    continuationTables(ply, cont);
+    for (const PieceToHistory *table : cont)
+    {
+        if (table)
+        {
+            score += (*table)[piece][to];
+        }
+    }
+    return score;
 }
\ No newline at end of file
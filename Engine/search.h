@@ -4,34 +4,164 @@
 #include "types.h"
 #include "transposition.h"
 #include "evaluation.h"
+#include "attack_info.h"
+#include "nnue.h"
+#include "tablebase.h"
+#include "stats.h"
+#include "history.h"
+#include <functional>
 #include <vector>
 
+// The board the search works on. chess.hpp pushes one State per move made
+// onto a vector; room for a whole search line is reserved when the root is
+// set, so make/unmake never reallocate inside the tree.
+class SearchBoard : public Board {
+public:
+    void set(const Board& board) {
+        Board::operator=(board);
+        prev_states_.reserve(prev_states_.size() + MAX_PLY + 1);
+    }
+    
+    // Draw by repetition: the position was seen before inside the search
+    // (the root included), or twice in the game before it. Like chess.hpp,
+    // only scans back to the last irreversible move.
+    bool isRepetitionDraw(int ply) const;
+};
+
 struct SearchResult {
     Move best_move;
     int score;
-    int nodes;
+    uint64_t nodes;
     PVLine pv;
 };
 
+// A root move with its results, kept across the iterations of one search
+struct RootMove {
+    Move move;
+    int score = -MATE_VALUE;           // This iteration; -MATE_VALUE if it didn't raise alpha
+    int previous_score = -MATE_VALUE;  // Last iteration
+    uint64_t nodes = 0;                // Subtree size in the last search of this move
+    PVLine pv;
+
+    explicit RootMove(Move m) : move(m) {}
+};
+
 class Search {
 public:
     Search(TranspositionTable& tt, Evaluation& eval);
     
-    SearchResult searchRoot(const Board& board, int depth, SearchInfo& info);
+    // Searches the root moves from pv_index on (MultiPV line pv_index + 1)
+    // and reorders them for the next search: by score, then the moves that
+    // failed low by subtree size. After a fail low the order is kept, so the
+    // previous best move stays first. The window defaults to full width; a narrower
+    // aspiration window may fail low (score <= alpha, no best move) or high
+    // (score >= beta).
+    SearchResult searchRoot(const Board& board, int depth, SearchInfo& info,
+                            int alpha = -MATE_VALUE, int beta = MATE_VALUE, int pv_index = 0);
     
     void setTranspositionTable(TranspositionTable& tt) { tt_ = &tt; }
+    void setNNUE(const NNUEEvaluation* nnue) { nnue_ = nnue; }
+    void setTablebase(const Tablebase* tb) { tb_ = tb; }
+    
+    // Called by searchRoot before each root move with the iteration depth and
+    // the move's 1-based number (UCI currmove reports)
+    using RootMoveCallback = std::function<void(int depth, Move move, int number)>;
+    void setRootMoveCallback(RootMoveCallback callback) { root_move_callback_ = std::move(callback); }
+    
+    // Set up the root move list for a new search, restricted to allowed
+    // (searchmoves, tablebase-preserving moves) unless that is empty.
+    // searchRoot() does this itself for a position it hasn't seen.
+    void initRootMoves(const Board& board, const std::vector<Move>& allowed);
+    const std::vector<RootMove>& rootMoves() const { return root_moves_; }
+    // Start a new iteration: this iteration's scores become the previous ones
+    void newIteration();
+    
+    // Forget the move ordering statistics (new game)
+    void clearHistory();
+    
+    // Empty unless built with SEARCH_STATS
+    const SearchStats& stats() const { return stats_; }
+    void clearStats() { stats_.clear(); }
     
 private:
+    // Qsearch skips captures that can't lift the score to alpha by this much
+    static constexpr int QS_DELTA_MARGIN = 200;
+    // SEE pruning below this depth; the margins scale with depth (and
+    // depth squared for captures, whose exchange values are larger)
+    static constexpr int SEE_PRUNE_DEPTH = 6;
+    static constexpr int SEE_QUIET_MARGIN = 60;
+    static constexpr int SEE_CAPTURE_MARGIN = 100;
+    // Reverse futility: a static eval this far above beta returns at once
+    static constexpr int RFP_DEPTH = 8;
+    static constexpr int RFP_MARGIN = 80;
+    // Futility: quiet moves are skipped when eval + base + margin * depth
+    // can't reach alpha
+    static constexpr int FUTILITY_DEPTH = 6;
+    static constexpr int FUTILITY_BASE = 100;
+    static constexpr int FUTILITY_MARGIN = 80;
+    // Late move pruning: quiet moves beyond lmpLimit() are skipped
+    static constexpr int LMP_DEPTH = 8;
+    // Singular extensions: from this depth, a TT move whose score every other
+    // move misses by SINGULAR_MARGIN * depth is extended, twice when they
+    // miss by DOUBLE_EXTENSION_MARGIN more (at most MAX_DOUBLE_EXTENSIONS
+    // times per line). Nothing is extended beyond twice the root depth.
+    static constexpr int SINGULAR_DEPTH = 7;
+    static constexpr int SINGULAR_MARGIN = 2;
+    static constexpr int DOUBLE_EXTENSION_MARGIN = 20;
+    static constexpr int MAX_DOUBLE_EXTENSIONS = 6;
+    
     TranspositionTable* tt_;
     Evaluation* eval_;
+    SearchBoard root_board_;  // Reused across searches, keeps its capacity
+    const NNUEEvaluation* nnue_ = nullptr;  // Used instead of eval_ when set
+    const Tablebase* tb_ = nullptr;
+    RootMoveCallback root_move_callback_;
+    std::vector<RootMove> root_moves_;
+    uint64_t root_hash_ = 0;
+    int root_depth_ = 0;
     
-    // History heuristic tables
-    int history_[2][64][64];  // [color][from][to]
+    // The move made at each ply, for countermoves and continuation history
+    struct StackEntry {
+        Move move;
+        int piece;                    // Moved piece, or -1 after a null move
+        PieceToHistory* cont;         // continuation[piece][to], or null
+        int static_eval;              // VALUE_NONE when in check
+        Move excluded;                // Skipped by the singular verification search
+        int double_extensions;        // Double extensions on the line to this ply
+    };
+    
+    HistoryTables history_;
     int killer_moves_[MAX_PLY][2];
+    StackEntry stack_[MAX_PLY + 1];
+    
+    // Triangular PV table: row ply holds the line from ply, in columns
+    // ply..pv_length_[ply]-1
+    Move pv_table_[MAX_PLY + 1][MAX_PLY + 1];
+    int pv_length_[MAX_PLY + 1];
+    
+    // Incremental evaluation state, one accumulator per ply
+    EvalAccumulator eval_stack_[MAX_PLY + 1];
+    NNUEAccumulator nnue_stack_[MAX_PLY + 1];
+    PawnHashTable pawn_table_;
+    SearchStats stats_;
+    
+    // Checkers, pins and attack maps of the node at each ply; set on entry
+    // to search and quiescence, read by their move loops and the evaluation
+    AttackInfo attack_info_[MAX_PLY + 1];
+    
+    // Board updates that keep eval_stack_ in sync
+    void makeMove(Board& board, const Move& move, int ply);
+    void unmakeMove(Board& board, const Move& move);
+    void makeNullMove(Board& board, int ply);
+    void unmakeNullMove(Board& board);
+    
+    // Static evaluation of the node at ply with the active backend
+    void initEvaluation(const Board& board);
+    int evaluatePosition(const Board& board, int ply);
     
     // Search methods
-    int search(Board& board, int depth, int ply, int alpha, int beta, 
-               PVLine& pv, SearchInfo& info, bool null_move_allowed = true);
+    int search(SearchBoard& board, int depth, int ply, int alpha, int beta,
+               SearchInfo& info, bool null_move_allowed = true);
     int quiescence(Board& board, int ply, int alpha, int beta, SearchInfo& info);
     
     // Move ordering
@@ -39,24 +169,31 @@ private:
     int getMoveScore(const Move& move, const Board& board, Move hash_move, int ply);
     
     // Search extensions and reductions
-    int getExtension(const Move& move, const Board& board, bool in_check);
-    int getReduction(const Move& move, int depth, int move_count, bool pv_node);
+    // Before the move is made: checks and promotions that don't lose material
+    int getExtension(const Board& board, const Move& move, bool gives_check);
+    int getReduction(int depth, int move_count, bool pv_node, int history);
+    static int lmpLimit(int depth, bool improving) { return (3 + depth * depth) / (improving ? 1 : 2); }
     
     // Null move pruning
     bool canDoNullMove(const Board& board);
     
-    // Principal Variation Search
-    int pvs(Board& board, int depth, int ply, int alpha, int beta, 
-            PVLine& pv, SearchInfo& info, bool pv_node);
-    
     // Mate distance pruning
     void mateDistancePruning(int& alpha, int& beta, int ply);
     
-    // Update search statistics
-    void updateHistory(const Move& move, Color color, int depth);
+    // Update search statistics. quiets/captures are the moves searched
+    // before move at this node, which get a malus
+    void updateQuietStats(const Board& board, const Move& move, int ply, int depth,
+                          const Move* quiets, int quiet_count);
+    void updateCaptureStats(const Board& board, const Move& move, int depth,
+                            const Move* captures, int capture_count);
     void updateKillers(const Move& move, int ply);
+    void updatePV(const Move& move, int ply);
     
-    void clearHistory();
+    // Record the move about to be made at ply on the search stack
+    void pushStack(const Board& board, const Move& move, int ply);
+    // Continuation histories of the moves one and two plies before ply
+    void continuationTables(int ply, const PieceToHistory* cont[2]) const;
+    int quietHistory(const Board& board, const Move& move, int ply) const;
 };
 
 #endif // SEARCH_H
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "see.h"
+
+Bitboard attackersTo(const Board &board, Square square, Bitboard occupied)
+{
+    Bitboard bishops = board.pieces(PieceType::BISHOP) | board.pieces(PieceType::QUEEN);
+    Bitboard rooks = board.pieces(PieceType::ROOK) | board.pieces(PieceType::QUEEN);
+
+    return (chess::attacks::pawn(Color::BLACK, square) & board.pieces(PieceType::PAWN, Color::WHITE)) |
+           (chess::attacks::pawn(Color::WHITE, square) & board.pieces(PieceType::PAWN, Color::BLACK)) |
+           (chess::attacks::knight(square) & board.pieces(PieceType::KNIGHT)) |
+           (chess::attacks::king(square) & board.pieces(PieceType::KING)) |
+           (chess::attacks::bishop(square, occupied) & bishops) |
+           (chess::attacks::rook(square, occupied) & rooks);
+}
+
+bool see(const Board &board, const Move &move, int threshold)
+{
+    // Castling, en passant and promotions are treated as neutral exchanges
+    if (move.typeOf() != Move::NORMAL)
+    {
+        return 0 >= threshold;
+    }
+
+    Square from = move.from();
+    Square to = move.to();
+
+    int swap = SEE_VALUES[static_cast<int>(board.at<PieceType>(to))] - threshold;
+    if (swap < 0)
+    {
+        return false;
+    }
+
+    swap = SEE_VALUES[static_cast<int>(board.at<PieceType>(from))] - swap;
+    if (swap <= 0)
+    {
+        return true;
+    }
+
+    Bitboard occupied = board.occ() ^ Bitboard::fromSquare(from) ^ Bitboard::fromSquare(to);
+    Bitboard attackers = attackersTo(board, to, occupied);
+    Bitboard bishops = board.pieces(PieceType::BISHOP) | board.pieces(PieceType::QUEEN);
+    Bitboard rooks = board.pieces(PieceType::ROOK) | board.pieces(PieceType::QUEEN);
+    Color stm = board.sideToMove();
+    int result = 1;
+
+    while (true)
+    {
+        stm = ~stm;
+        attackers &= occupied;
+
+        Bitboard stm_attackers = attackers & board.us(stm);
+        if (!stm_attackers)
+        {
+            break;
+        }
+
+        result ^= 1;
+
+        // Recapture with the least valuable attacker, revealing x-rays behind it
+        Bitboard bb;
+        if ((bb = stm_attackers & board.pieces(PieceType::PAWN)))
+        {
+            if ((swap = SEE_VALUES[0] - swap) < result)
+                break;
+            occupied ^= Bitboard::fromSquare(Square(bb.lsb()));
+            attackers |= chess::attacks::bishop(to, occupied) & bishops;
+        }
+        else if ((bb = stm_attackers & board.pieces(PieceType::KNIGHT)))
+        {
+            if ((swap = SEE_VALUES[1] - swap) < result)
+                break;
+            occupied ^= Bitboard::fromSquare(Square(bb.lsb()));
+        }
+        else if ((bb = stm_attackers & board.pieces(PieceType::BISHOP)))
+        {
+            if ((swap = SEE_VALUES[2] - swap) < result)
+                break;
+            occupied ^= Bitboard::fromSquare(Square(bb.lsb()));
+            attackers |= chess::attacks::bishop(to, occupied) & bishops;
+        }
+        else if ((bb = stm_attackers & board.pieces(PieceType::ROOK)))
+        {
+            if ((swap = SEE_VALUES[3] - swap) < result)
+                break;
+            occupied ^= Bitboard::fromSquare(Square(bb.lsb()));
+            attackers |= chess::attacks::rook(to, occupied) & rooks;
+        }
+        else if ((bb = stm_attackers & board.pieces(PieceType::QUEEN)))
+        {
+            if ((swap = SEE_VALUES[4] - swap) < result)
+                break;
+            occupied ^= Bitboard::fromSquare(Square(bb.lsb()));
+            attackers |= (chess::attacks::bishop(to, occupied) & bishops) |
+                         (chess::attacks::rook(to, occupied) & rooks);
+        }
+        else
+        {
+            // King recapture only works if the opponent has no attackers left
+            return (attackers & ~board.us(stm)) ? result ^ 1 : result;
+        }
+    }
+
+    return static_cast<bool>(result);
+}
@@ -0,0 +1,16 @@
+#ifndef SEE_H
+#define SEE_H
+
+#include "types.h"
+
+// Piece values used by static exchange evaluation, indexed by PieceType
+constexpr int SEE_VALUES[7] = {100, 320, 330, 500, 900, 20000, 0}; // P, N, B, R, Q, K, NONE
+
+// Static exchange evaluation: true if the capture sequence started by move
+// on its target square wins at least threshold centipawns for the mover.
+bool see(const Board& board, const Move& move, int threshold = 0);
+
+// All pieces of both colors attacking square with the given occupancy
+Bitboard attackersTo(const Board& board, Square square, Bitboard occupied);
+
+#endif // SEE_H
@@ -0,0 +1,93 @@
+#include "server.h"
+#include "engine.h"
+#include "uci.h"
+#include "uci_output.h"
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+    // One game: an engine and its UCI front end, tagging its output
+    struct Session
+    {
+        ChessEngine engine;
+        UCIHandler uci;
+
+        Session(const std::string &id, std::shared_ptr<TranspositionTable> tt)
+            : engine(std::move(tt)), uci(engine)
+        {
+            engine.setOutputPrefix(id + " ");
+        }
+
+        ~Session()
+        {
+            engine.stopSearch();
+            engine.waitForSearch();
+        }
+    };
+}
+
+int runServer(int hash_mb, int threads, int max_sessions)
+{
+    if (threads <= 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    SharedResources::setHelperBudget(threads - 1);
+
+    auto tt = std::make_shared<TranspositionTable>(hash_mb, threads);
+    std::map<std::string, std::unique_ptr<Session>> sessions;
+
+    uciOutput().start();
+    uciOutput().send("info string server ready: " + std::to_string(hash_mb) + " MB hash, " +
+                     std::to_string(threads) + " threads, up to " + std::to_string(max_sessions) + " sessions");
+
+    std::string line;
+    while (std::getline(std::cin, line))
+    {
+        std::istringstream iss(line);
+        std::string id;
+        if (!(iss >> id))
+        {
+            continue;
+        }
+        if (id == "quit")
+        {
+            break;
+        }
+
+        std::string command;
+        std::getline(iss >> std::ws, command);
+
+        auto it = sessions.find(id);
+        if (command == "quit")
+        {
+            if (it != sessions.end())
+            {
+                sessions.erase(it);
+            }
+            continue;
+        }
+
+        if (it == sessions.end())
+        {
+            if (static_cast<int>(sessions.size()) >= max_sessions)
+            {
+                uciOutput().send("info string too many sessions (at most " + std::to_string(max_sessions) + ")",
+                                 id + " ");
+                continue;
+            }
+            it = sessions.emplace(id, std::make_unique<Session>(id, tt)).first;
+        }
+        it->second->uci.processCommand(command);
+    }
+
+    // Sessions end their searches (and send bestmove) before output stops
+    sessions.clear();
+    uciOutput().stop();
+    return 0;
+}
@@ -0,0 +1,20 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+constexpr int SERVER_DEFAULT_HASH_MB = 1024;
+constexpr int SERVER_DEFAULT_SESSIONS = 16;
+
+// Hosts many independent games in one process. Every stdin line is
+// "<session> <uci command>", and every line a session sends comes back as
+// "<session> <line>". A session starts with the first line naming it and
+// ends with "<session> quit"; a bare "quit" ends the server.
+//
+// All sessions search one shared transposition table of hash_mb (their Hash
+// option is ignored) and share books, networks and tablebases through
+// SharedResources. threads is the core count for the whole server (0 = all
+// cores): every search runs on its own thread and borrows its Threads - 1
+// helpers from a common budget of threads - 1.
+int runServer(int hash_mb = SERVER_DEFAULT_HASH_MB, int threads = 0,
+              int max_sessions = SERVER_DEFAULT_SESSIONS);
+
+#endif // SERVER_H
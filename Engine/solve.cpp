@@ -0,0 +1,293 @@
+#include "solve.h"
+#include "search.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Puzzle
+    {
+        int index = 0;
+        std::string fen;
+        std::string solution;
+    };
+
+    // Pulls puzzles from the file one at a time, shared by all solver threads
+    class PuzzleReader
+    {
+    public:
+        explicit PuzzleReader(std::istream &in, bool json) : in_(in), json_(json), count_(0) {}
+
+        bool next(Puzzle &puzzle)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            bool found = json_ ? nextJson(puzzle) : nextText(puzzle);
+            if (found)
+            {
+                puzzle.index = ++count_;
+            }
+            return found;
+        }
+
+    private:
+        std::istream &in_;
+        bool json_;
+        int count_;
+        std::mutex mutex_;
+
+        // Next string literal of a flat JSON object; keys and values alternate
+        bool readString(std::string &out)
+        {
+            out.clear();
+            char c;
+            while (in_.get(c) && c != '"')
+            {
+            }
+            while (in_.get(c) && c != '"')
+            {
+                if (c == '\\' && !in_.get(c))
+                {
+                    return false;
+                }
+                out += c;
+            }
+            return static_cast<bool>(in_);
+        }
+
+        bool nextJson(Puzzle &puzzle)
+        {
+            return readString(puzzle.fen) && readString(puzzle.solution);
+        }
+
+        // m8n*.txt: free text, then a FEN line followed by "1. <moves>"
+        bool nextText(Puzzle &puzzle)
+        {
+            std::string line;
+            puzzle.fen.clear();
+            while (std::getline(in_, line))
+            {
+                if (!line.empty() && line.back() == '\r')
+                {
+                    line.pop_back();
+                }
+
+                if (std::count(line.begin(), line.end(), '/') == 7 && line.find(' ') != std::string::npos)
+                {
+                    puzzle.fen = line;
+                }
+                else if (!puzzle.fen.empty() && line.rfind("1.", 0) == 0)
+                {
+                    puzzle.solution = line;
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    struct SolveResult
+    {
+        bool solved = false;
+        int depth = 0;
+        int64_t ms = 0;    // Time to solution, or the full budget when unsolved
+        uint64_t nodes = 0;
+        Move best_move = Move::NO_MOVE;
+        int score = 0;
+    };
+
+    struct SolveTotals
+    {
+        int positions = 0;
+        int solved = 0;
+        int invalid = 0;
+        int64_t solve_ms = 0;
+        uint64_t nodes = 0;
+    };
+
+    // SAN tokens of a solution line, without move numbers or annotations
+    std::vector<std::string> solutionMoves(const std::string &solution)
+    {
+        std::vector<std::string> moves;
+        std::istringstream iss(solution);
+        std::string token;
+        while (iss >> token)
+        {
+            size_t dot = token.find_last_of('.');
+            if (dot != std::string::npos)
+            {
+                token = token.substr(dot + 1);
+            }
+            while (!token.empty() && (token.back() == '!' || token.back() == '?'))
+            {
+                token.pop_back();
+            }
+            // Some suites write promotions as e8/Q
+            std::replace(token.begin(), token.end(), '/', '=');
+            if (!token.empty() && token != "*" && token != "1-0" && token != "0-1")
+            {
+                moves.push_back(token);
+            }
+        }
+        return moves;
+    }
+
+    SolveResult solvePosition(Search &search, TranspositionTable &tt, const Board &board,
+                              Move expected, int mate_moves, int movetime_ms)
+    {
+        SolveResult result;
+        SearchInfo info;
+
+        // Every puzzle starts from a cold table
+        tt.clear();
+        info.reset();
+        info.time_limit = movetime_ms;
+
+        for (int d = 1; d <= MAX_DEPTH; ++d)
+        {
+            auto iteration = search.searchRoot(board, d, info);
+            if (info.should_stop())
+            {
+                break;
+            }
+
+            result.depth = d;
+            result.best_move = iteration.best_move;
+            result.score = iteration.score;
+
+            // Any mate at most as long as the given one, or the given first
+            // move backed by a mate score (the suites are "almost unique")
+            bool mate = iteration.score > MATE_IN_MAX_PLY;
+            int mate_in = (MATE_VALUE - iteration.score + 1) / 2;
+            if (mate && (mate_in <= mate_moves || iteration.best_move == expected))
+            {
+                result.solved = true;
+                break;
+            }
+        }
+
+        result.ms = std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - info.start_time).count();
+        result.nodes = static_cast<uint64_t>(info.nodes);
+        return result;
+    }
+
+    void solverThread(PuzzleReader &reader, SolveTotals &totals, std::mutex &mutex, int movetime_ms)
+    {
+        // Private table and searcher: no sharing between threads
+        TranspositionTable tt(SOLVE_HASH_MB);
+        Evaluation evaluation;
+        auto search = std::make_unique<Search>(tt, evaluation);
+
+        Puzzle puzzle;
+        while (reader.next(puzzle))
+        {
+            Board board;
+            Move expected = Move::NO_MOVE;
+            std::vector<std::string> moves = solutionMoves(puzzle.solution);
+
+            bool valid = board.setFen(puzzle.fen) && !moves.empty();
+            if (valid)
+            {
+                try
+                {
+                    expected = chess::uci::parseSan(board, moves[0]);
+                }
+                catch (const std::exception &)
+                {
+                    expected = Move::NO_MOVE;
+                }
+                valid = expected != Move::NO_MOVE;
+            }
+
+            if (!valid)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++totals.invalid;
+                std::cerr << "#" << puzzle.index << " skipped (unreadable): " << puzzle.fen << std::endl;
+                continue;
+            }
+
+            int mate_moves = static_cast<int>(moves.size() + 1) / 2;
+            SolveResult result = solvePosition(*search, tt, board, expected, mate_moves, movetime_ms);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            ++totals.positions;
+            totals.nodes += result.nodes;
+            if (result.solved)
+            {
+                ++totals.solved;
+                totals.solve_ms += result.ms;
+            }
+
+            std::cerr << "#" << puzzle.index << (result.solved ? " solved " : " FAILED ")
+                      << "depth " << result.depth << " " << result.ms << " ms "
+                      << result.nodes << " nodes  "
+                      << (result.best_move != Move::NO_MOVE ? chess::uci::moveToSan(board, result.best_move) : "-")
+                      << " (" << moves[0] << ")";
+            if (!result.solved)
+            {
+                std::cerr << "  " << puzzle.fen;
+            }
+            std::cerr << std::endl;
+        }
+    }
+}
+
+int runSolve(const std::string &path, int threads, int movetime_ms)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        std::cerr << "Could not open puzzle file: " << path << std::endl;
+        return 1;
+    }
+
+    if (threads <= 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    movetime_ms = std::max(1, movetime_ms);
+
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    PuzzleReader reader(file, json);
+    SolveTotals totals;
+    std::mutex mutex;
+
+    std::cerr << "Solving " << path << " with " << threads << " thread(s), "
+              << movetime_ms << " ms per position" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(solverThread, std::ref(reader), std::ref(totals), std::ref(mutex), movetime_ms);
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    int64_t wall_ms = std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - start).count();
+    int64_t wall = std::max<int64_t>(1, wall_ms);
+    double rate = totals.positions > 0 ? 100.0 * totals.solved / totals.positions : 0.0;
+
+    std::cerr << "===========================" << std::endl
+              << "Solved         : " << totals.solved << "/" << totals.positions
+              << " (" << std::fixed << std::setprecision(1) << rate << "%)" << std::endl
+              << "Skipped        : " << totals.invalid << std::endl
+              << "Avg solve (ms) : " << (totals.solved > 0 ? totals.solve_ms / totals.solved : 0) << std::endl
+              << "Wall time (ms) : " << wall_ms << std::endl
+              << "Positions/min  : " << (static_cast<int64_t>(totals.positions) * 60000 / wall) << std::endl
+              << "Nodes          : " << totals.nodes << std::endl
+              << "NPS            : " << (totals.nodes * 1000 / static_cast<uint64_t>(wall)) << std::endl;
+
+    return totals.solved == totals.positions && totals.invalid == 0 ? 0 : 1;
+}
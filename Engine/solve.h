@@ -0,0 +1,21 @@
+#ifndef SOLVE_H
+#define SOLVE_H
+
+#include <string>
+
+// Hash size of each solver thread's private transposition table
+constexpr int SOLVE_HASH_MB = 16;
+constexpr int SOLVE_DEFAULT_MOVETIME_MS = 2000;
+
+// Headless puzzle solver. Reads a FEN -> solution file, either the Week3
+// JSON objects ({"<fen>": "<SAN line>", ...}) or the m8n*.txt suites (a FEN
+// line followed by a numbered SAN line), and solves the positions in
+// parallel, each thread with its own Search and TranspositionTable.
+// A position counts as solved once an iteration finds a mate no longer
+// than the given solution, or plays the solution's first move with a mate
+// score. Prints one line per position and a summary; returns non-zero if
+// the file can't be read or any position is unsolved or unreadable.
+int runSolve(const std::string& path, int threads = 0,
+             int movetime_ms = SOLVE_DEFAULT_MOVETIME_MS);
+
+#endif // SOLVE_H
@@ -0,0 +1,93 @@
+#include "stats.h"
+#include <iomanip>
+
+namespace
+{
+    double percent(uint64_t part, uint64_t total)
+    {
+        return total > 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(total) : 0.0;
+    }
+
+    // Effective branching factor of an iteration over the previous one
+    double branching(const SearchStats &stats, int depth)
+    {
+        uint64_t previous = stats.depth_nodes[depth - 1];
+        return previous > 0 ? static_cast<double>(stats.depth_nodes[depth]) / static_cast<double>(previous) : 0.0;
+    }
+}
+
+void SearchStats::merge(const SearchStats &other)
+{
+    nodes += other.nodes;
+    qnodes += other.qnodes;
+    tt_probes += other.tt_probes;
+    tt_hits += other.tt_hits;
+    tt_cutoffs += other.tt_cutoffs;
+    fail_highs += other.fail_highs;
+    fail_highs_first += other.fail_highs_first;
+    null_tries += other.null_tries;
+    null_cutoffs += other.null_cutoffs;
+    lmr_searches += other.lmr_searches;
+    lmr_researches += other.lmr_researches;
+    pvs_researches += other.pvs_researches;
+    singular_searches += other.singular_searches;
+    singular_extensions += other.singular_extensions;
+    multi_cuts += other.multi_cuts;
+    for (int d = 0; d <= MAX_DEPTH; ++d)
+    {
+        depth_nodes[d] += other.depth_nodes[d];
+    }
+}
+
+void SearchStats::print(std::ostream &os, const char *prefix) const
+{
+    os << std::fixed << std::setprecision(1);
+    os << prefix << "nodes " << nodes << " qnodes " << qnodes
+       << " (" << percent(qnodes, nodes + qnodes) << "% qsearch)\n";
+    os << prefix << "tt probes " << tt_probes << " hits " << percent(tt_hits, tt_probes)
+       << "% cutoffs " << percent(tt_cutoffs, tt_probes) << "%\n";
+    os << prefix << "fail highs " << fail_highs << " first move " << percent(fail_highs_first, fail_highs) << "%\n";
+    os << prefix << "null move tries " << null_tries << " cutoffs " << percent(null_cutoffs, null_tries) << "%\n";
+    os << prefix << "lmr searches " << lmr_searches << " re-searches " << percent(lmr_researches, lmr_searches)
+       << "% pvs re-searches " << pvs_researches << "\n";
+    os << prefix << "singular searches " << singular_searches << " extended "
+       << percent(singular_extensions, singular_searches) << "% multi-cut "
+       << percent(multi_cuts, singular_searches) << "%\n";
+
+    os << std::setprecision(2);
+    for (int d = 2; d <= MAX_DEPTH && depth_nodes[d] > 0; ++d)
+    {
+        os << prefix << "depth " << d << " nodes " << depth_nodes[d] << " ebf " << branching(*this, d) << "\n";
+    }
+    os << std::defaultfloat;
+}
+
+void SearchStats::printJson(std::ostream &os) const
+{
+    os << "{\"nodes\":" << nodes
+       << ",\"qnodes\":" << qnodes
+       << ",\"tt_probes\":" << tt_probes
+       << ",\"tt_hits\":" << tt_hits
+       << ",\"tt_cutoffs\":" << tt_cutoffs
+       << ",\"fail_highs\":" << fail_highs
+       << ",\"fail_highs_first\":" << fail_highs_first
+       << ",\"null_tries\":" << null_tries
+       << ",\"null_cutoffs\":" << null_cutoffs
+       << ",\"lmr_searches\":" << lmr_searches
+       << ",\"lmr_researches\":" << lmr_researches
+       << ",\"pvs_researches\":" << pvs_researches
+       << ",\"singular_searches\":" << singular_searches
+       << ",\"singular_extensions\":" << singular_extensions
+       << ",\"multi_cuts\":" << multi_cuts
+       << ",\"depth_nodes\":[";
+    int last = MAX_DEPTH;
+    while (last > 0 && depth_nodes[last] == 0)
+    {
+        --last;
+    }
+    for (int d = 1; d <= last; ++d)
+    {
+        os << (d > 1 ? "," : "") << depth_nodes[d];
+    }
+    os << "]}";
+}
@@ -0,0 +1,45 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "types.h"
+#include <ostream>
+
+// Search statistics for tuning reductions, null move and move ordering.
+// Counting is compiled in with `make STATS=1` (-DSEARCH_STATS); otherwise
+// SEARCH_STAT() expands to nothing and the hot path is unchanged.
+#ifdef SEARCH_STATS
+#define SEARCH_STAT(stmt) (stmt)
+constexpr bool SEARCH_STATS_ENABLED = true;
+#else
+#define SEARCH_STAT(stmt) ((void)0)
+constexpr bool SEARCH_STATS_ENABLED = false;
+#endif
+
+struct SearchStats {
+    uint64_t nodes = 0;            // Main search nodes
+    uint64_t qnodes = 0;           // Quiescence nodes
+    uint64_t tt_probes = 0;
+    uint64_t tt_hits = 0;
+    uint64_t tt_cutoffs = 0;
+    uint64_t fail_highs = 0;       // Beta cutoffs in the main search
+    uint64_t fail_highs_first = 0; // ... produced by the first move searched
+    uint64_t null_tries = 0;
+    uint64_t null_cutoffs = 0;
+    uint64_t lmr_searches = 0;
+    uint64_t lmr_researches = 0;   // Reduced search beat alpha: full-depth re-search
+    uint64_t pvs_researches = 0;   // Null-window search landed inside the window
+    uint64_t singular_searches = 0;    // Excluded-move verification searches
+    uint64_t singular_extensions = 0;  // ... that found the TT move singular
+    uint64_t multi_cuts = 0;           // ... that failed high without it
+    uint64_t depth_nodes[MAX_DEPTH + 1] = {};  // Nodes spent per iteration depth
+
+    void clear() { *this = SearchStats(); }
+    void merge(const SearchStats& other);
+
+    // One "name value" line per statistic, each behind prefix
+    void print(std::ostream& os, const char* prefix) const;
+    // A single JSON object
+    void printJson(std::ostream& os) const;
+};
+
+#endif // STATS_H
@@ -0,0 +1,157 @@
+#include "tablebase.h"
+#include <iostream>
+
+#ifdef USE_SYZYGY
+#include "tbprobe.h"
+#endif
+
+Tablebase::Tablebase() : largest_(0) {}
+
+Tablebase::~Tablebase()
+{
+#ifdef USE_SYZYGY
+    if (largest_ > 0)
+    {
+        tb_free();
+    }
+#endif
+}
+
+bool Tablebase::init(const std::string &path)
+{
+#ifdef USE_SYZYGY
+    largest_ = 0;
+
+    if (path.empty() || path == "<empty>")
+    {
+        tb_free();
+        return false;
+    }
+
+    if (!tb_init(path.c_str()) || TB_LARGEST == 0)
+    {
+        std::cout << "info string No Syzygy tablebases found in " << path << std::endl;
+        return false;
+    }
+
+    largest_ = static_cast<int>(TB_LARGEST);
+    std::cout << "info string Syzygy tablebases loaded, up to " << largest_ << " pieces" << std::endl;
+    return true;
+#else
+    if (!path.empty() && path != "<empty>")
+    {
+        std::cout << "info string Syzygy support not compiled in (build with SYZYGY=1)" << std::endl;
+    }
+    return false;
+#endif
+}
+
+int Tablebase::probeWDL(const Board &board) const
+{
+#ifdef USE_SYZYGY
+    if (!canProbeWDL(board))
+    {
+        return -1;
+    }
+
+    Square ep_sq = board.enpassantSq();
+    unsigned result = tb_probe_wdl(board.us(Color::WHITE).getBits(), board.us(Color::BLACK).getBits(),
+                                   board.pieces(PieceType::KING).getBits(), board.pieces(PieceType::QUEEN).getBits(),
+                                   board.pieces(PieceType::ROOK).getBits(), board.pieces(PieceType::BISHOP).getBits(),
+                                   board.pieces(PieceType::KNIGHT).getBits(), board.pieces(PieceType::PAWN).getBits(),
+                                   0, 0, ep_sq != Square::NO_SQ ? ep_sq.index() : 0,
+                                   board.sideToMove() == Color::WHITE);
+
+    return result == TB_RESULT_FAILED ? -1 : static_cast<int>(result);
+#else
+    (void)board;
+    return -1;
+#endif
+}
+
+bool Tablebase::probeRoot(const Board &board, std::vector<Move> &moves) const
+{
+    moves.clear();
+
+#ifdef USE_SYZYGY
+    if (largest_ == 0 || board.occ().count() > largest_ || !board.castlingRights().isEmpty())
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(root_mutex_);
+    Square ep_sq = board.enpassantSq();
+    unsigned results[TB_MAX_MOVES];
+    unsigned result = tb_probe_root(board.us(Color::WHITE).getBits(), board.us(Color::BLACK).getBits(),
+                                    board.pieces(PieceType::KING).getBits(), board.pieces(PieceType::QUEEN).getBits(),
+                                    board.pieces(PieceType::ROOK).getBits(), board.pieces(PieceType::BISHOP).getBits(),
+                                    board.pieces(PieceType::KNIGHT).getBits(), board.pieces(PieceType::PAWN).getBits(),
+                                    board.halfMoveClock(), 0, ep_sq != Square::NO_SQ ? ep_sq.index() : 0,
+                                    board.sideToMove() == Color::WHITE, results);
+
+    if (result == TB_RESULT_FAILED || result == TB_RESULT_CHECKMATE || result == TB_RESULT_STALEMATE)
+    {
+        return false;
+    }
+
+    // Best result any move reaches (WDL here already accounts for the 50-move counter)
+    unsigned best_wdl = 0;
+    for (int i = 0; results[i] != TB_RESULT_FAILED; ++i)
+    {
+        best_wdl = std::max(best_wdl, TB_GET_WDL(results[i]));
+    }
+
+    // Winning: shortest distance to zeroing; losing: longest; drawn: any
+    unsigned best_dtz = (best_wdl == TB_WIN) ? ~0u : 0;
+    for (int i = 0; results[i] != TB_RESULT_FAILED; ++i)
+    {
+        if (TB_GET_WDL(results[i]) != best_wdl)
+        {
+            continue;
+        }
+        unsigned dtz = TB_GET_DTZ(results[i]);
+        best_dtz = (best_wdl == TB_WIN) ? std::min(best_dtz, dtz) : std::max(best_dtz, dtz);
+    }
+
+    for (int i = 0; results[i] != TB_RESULT_FAILED; ++i)
+    {
+        unsigned entry = results[i];
+        if (TB_GET_WDL(entry) != best_wdl)
+        {
+            continue;
+        }
+        if ((best_wdl == TB_WIN || best_wdl == TB_LOSS) && TB_GET_DTZ(entry) != best_dtz)
+        {
+            continue;
+        }
+
+        Square from(static_cast<int>(TB_GET_FROM(entry)));
+        Square to(static_cast<int>(TB_GET_TO(entry)));
+
+        switch (TB_GET_PROMOTES(entry))
+        {
+        case TB_PROMOTES_QUEEN:
+            moves.push_back(Move::make<Move::PROMOTION>(from, to, PieceType::QUEEN));
+            break;
+        case TB_PROMOTES_ROOK:
+            moves.push_back(Move::make<Move::PROMOTION>(from, to, PieceType::ROOK));
+            break;
+        case TB_PROMOTES_BISHOP:
+            moves.push_back(Move::make<Move::PROMOTION>(from, to, PieceType::BISHOP));
+            break;
+        case TB_PROMOTES_KNIGHT:
+            moves.push_back(Move::make<Move::PROMOTION>(from, to, PieceType::KNIGHT));
+            break;
+        default:
+            moves.push_back(TB_GET_EP(entry) ? Move::make<Move::ENPASSANT>(from, to)
+                                             : Move::make<Move::NORMAL>(from, to));
+            break;
+        }
+    }
+
+    return !moves.empty();
+#else
+    (void)board;
+    return false;
+#endif
+}
@@ -0,0 +1,52 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include "types.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Win/draw/loss from the side to move's point of view, in Fathom's order.
+// Cursed wins and blessed losses are drawn under the 50-move rule.
+enum TBWdl {
+    WDL_LOSS = 0,
+    WDL_BLESSED_LOSS = 1,
+    WDL_DRAW = 2,
+    WDL_CURSED_WIN = 3,
+    WDL_WIN = 4
+};
+
+// Syzygy tablebases through Fathom. Probing is compiled in with
+// `make SYZYGY=1`; otherwise init() fails and every probe is a miss.
+class Tablebase {
+public:
+    Tablebase();
+    ~Tablebase();
+
+    bool init(const std::string& path);
+    bool isAvailable() const { return largest_ > 0; }
+    int largest() const { return largest_; }
+
+    // Cheap filter for the search: few enough pieces, no castling rights
+    // and a fresh 50-move counter (WDL tables can't account for it)
+    bool canProbeWDL(const Board& board) const {
+        return board.occ().count() <= largest_ && board.halfMoveClock() == 0 &&
+               board.castlingRights().isEmpty();
+    }
+
+    // Returns a TBWdl, or -1 when the position is not in the tables.
+    // Thread-safe.
+    int probeWDL(const Board& board) const;
+
+    // Fills moves with the root moves that keep the best DTZ-backed result,
+    // and among those the fastest conversion (slowest loss when lost).
+    // Fathom's root probe isn't thread-safe; calls are serialized, which
+    // matters when several engines share the tables (resources.h).
+    bool probeRoot(const Board& board, std::vector<Move>& moves) const;
+
+private:
+    int largest_;
+    mutable std::mutex root_mutex_;
+};
+
+#endif // TABLEBASE_H
@@ -0,0 +1,98 @@
+#include "timeman.h"
+#include <algorithm>
+
+TimeManager::TimeManager()
+    : active_(false), fixed_(false), soft_ms_(0), hard_ms_(0),
+      last_best_(Move::NO_MOVE), last_score_(0), stability_(0), score_factor_(1.0) {}
+
+void TimeManager::init(int our_time, int our_inc, int movestogo, int movetime, bool infinite, int move_overhead)
+{
+    active_ = false;
+    fixed_ = false;
+    soft_ms_ = hard_ms_ = 0;
+    last_best_ = Move::NO_MOVE;
+    last_score_ = 0;
+    stability_ = 0;
+    score_factor_ = 1.0;
+
+    if (infinite)
+    {
+        return;
+    }
+
+    if (movetime > 0)
+    {
+        active_ = fixed_ = true;
+        soft_ms_ = hard_ms_ = std::max(1, movetime - move_overhead);
+        return;
+    }
+
+    if (our_time <= 0)
+    {
+        return;
+    }
+
+    active_ = true;
+
+    // Keep the overhead in reserve so the clock never runs out on us
+    int available = std::max(1, our_time - move_overhead);
+    int moves_left = (movestogo > 0) ? std::min(movestogo, 50) : DEFAULT_MOVES_TO_GO;
+
+    soft_ms_ = available / moves_left + our_inc * 3 / 4;
+
+    // One move may take several soft budgets, but never most of the clock
+    int hard_cap = (moves_left == 1) ? available * 9 / 10 : available / 3;
+    hard_ms_ = std::min(soft_ms_ * 5, hard_cap);
+    soft_ms_ = std::min(soft_ms_, hard_ms_);
+
+    soft_ms_ = std::max(1, soft_ms_);
+    hard_ms_ = std::max(1, hard_ms_);
+}
+
+void TimeManager::update(int depth, Move best_move, int score)
+{
+    // Best-move stability: count consecutive iterations with the same move
+    if (depth > 1 && best_move == last_best_)
+    {
+        stability_ = std::min(stability_ + 1, 4);
+    }
+    else
+    {
+        stability_ = 0;
+    }
+
+    // Spend more time when the score drops between iterations
+    if (depth > 1)
+    {
+        int drop = last_score_ - score;
+        score_factor_ = 1.0 + std::clamp(drop, 0, 150) / 250.0;
+    }
+
+    last_best_ = best_move;
+    last_score_ = score;
+}
+
+bool TimeManager::shouldStartIteration(int elapsed_ms, int last_iteration_ms) const
+{
+    if (!active_)
+    {
+        return true;
+    }
+
+    // Fixed movetime only stops on the hard deadline
+    if (fixed_)
+    {
+        return elapsed_ms < hard_ms_;
+    }
+
+    static constexpr double STABILITY_SCALE[5] = {2.0, 1.3, 1.0, 0.85, 0.7};
+    double scaled_soft = soft_ms_ * STABILITY_SCALE[stability_] * score_factor_;
+
+    if (elapsed_ms >= std::min(scaled_soft, static_cast<double>(hard_ms_)))
+    {
+        return false;
+    }
+
+    // The next iteration usually takes a few times as long as the last one
+    return elapsed_ms + 2 * last_iteration_ms < hard_ms_;
+}
@@ -0,0 +1,39 @@
+#ifndef TIMEMAN_H
+#define TIMEMAN_H
+
+#include "types.h"
+
+// Per-move time allocation with a soft deadline (checked between iterations
+// and scaled by best-move stability and score drops) and a hard deadline
+// (enforced inside the search through SearchInfo::time_limit).
+class TimeManager {
+public:
+    TimeManager();
+
+    void init(int our_time, int our_inc, int movestogo, int movetime, bool infinite, int move_overhead);
+
+    bool isActive() const { return active_; }
+    int softLimit() const { return soft_ms_; }
+    int hardLimit() const { return hard_ms_; }
+
+    // Record a completed iteration
+    void update(int depth, Move best_move, int score);
+
+    // Whether another iteration fits in the remaining time
+    bool shouldStartIteration(int elapsed_ms, int last_iteration_ms) const;
+
+private:
+    static constexpr int DEFAULT_MOVES_TO_GO = 30;
+
+    bool active_;
+    bool fixed_;  // movetime: spend exactly the given time
+    int soft_ms_;
+    int hard_ms_;
+
+    Move last_best_;
+    int last_score_;
+    int stability_;
+    double score_factor_;
+};
+
+#endif // TIMEMAN_H
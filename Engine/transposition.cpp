@@ -1,80 +1,187 @@
 #include "transposition.h"
 #include <cstring>
 #include <algorithm>
+#include <new>
+#include <thread>
 
-TranspositionTable::TranspositionTable(int size_mb) : age_(0) {
-    // Calculate table size (power of 2)
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace {
+    constexpr size_t LARGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    // 2 MB aligned and rounded so the kernel can back the table with
+    // transparent huge pages: one TLB entry then covers 32768 buckets
+    // instead of 64, which is what random TT probes miss on.
+    void* allocateTable(size_t bytes) {
+        size_t size = (bytes + LARGE_PAGE_SIZE - 1) / LARGE_PAGE_SIZE * LARGE_PAGE_SIZE;
+        void* mem = std::aligned_alloc(LARGE_PAGE_SIZE, size);
+        if (!mem) {
+            throw std::bad_alloc();
+        }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        madvise(mem, size, MADV_HUGEPAGE);
+#endif
+        return mem;
+    }
+}
+
+TranspositionTable::TranspositionTable(int size_mb, int threads) : bucket_count_(0), bucket_mask_(0), age_(0) {
+    resize(size_mb, threads);
+}
+
+TranspositionTable::~TranspositionTable() = default;
+
+void TranspositionTable::resize(int size_mb, int threads) {
+    // Calculate bucket count (power of 2)
     size_t size_bytes = static_cast<size_t>(size_mb) * 1024 * 1024;
-    table_size_ = size_bytes / sizeof(TTEntry);
-    
+    size_t buckets = std::max<size_t>(1, size_bytes / sizeof(TTBucket));
+
     // Round down to power of 2
     size_t power = 1;
-    while (power <= table_size_) {
+    while (power <= buckets) {
         power <<= 1;
     }
-    table_size_ = power >> 1;
-    table_mask_ = table_size_ - 1;
-    
-    table_ = std::make_unique<TTEntry[]>(table_size_);
-    clear();
+    buckets = power >> 1;
+
+    // Free the old table first so both never exist at once
+    table_.reset();
+    table_.reset(static_cast<TTBucket*>(allocateTable(buckets * sizeof(TTBucket))));
+    bucket_count_ = buckets;
+    bucket_mask_ = bucket_count_ - 1;
+    clear(threads);
 }
 
-TranspositionTable::~TranspositionTable() = default;
+uint64_t TranspositionTable::pack(Move move, int score, int eval, int depth, TTFlag flag, uint8_t age) {
+    return static_cast<uint64_t>(move.move())
+         | static_cast<uint64_t>(static_cast<uint16_t>(score)) << 16
+         | static_cast<uint64_t>(static_cast<uint16_t>(eval)) << 32
+         | static_cast<uint64_t>(static_cast<uint8_t>(std::clamp(depth, 0, 255))) << 48
+         | static_cast<uint64_t>((age << 2) | (flag & 0x3)) << 56;
+}
+
+TTEntry TranspositionTable::unpack(uint64_t hash, uint64_t data) {
+    TTEntry entry;
+    entry.hash = hash;
+    entry.move = Move(static_cast<uint16_t>(data));
+    entry.score = static_cast<int16_t>(data >> 16);
+    entry.eval = static_cast<int16_t>(data >> 32);
+    entry.depth = static_cast<uint8_t>(data >> 48);
+    entry.flag = static_cast<uint8_t>((data >> 56) & 0x3);
+    entry.age = static_cast<uint8_t>(data >> 58);
+    return entry;
+}
+
+int TranspositionTable::replacementScore(const TTEntry& entry) const {
+    int relative_age = (age_ - entry.age) & AGE_MASK;
+    return entry.depth - 8 * relative_age;
+}
 
 void TranspositionTable::store(uint64_t hash, int depth, int score, TTFlag flag, Move move, int eval) {
-    size_t index = getIndex(hash);
-    TTEntry& entry = table_[index];
-    
-    // Always replace if hash matches or if this is a better entry
-    if (entry.hash != hash || shouldReplace(entry, depth, age_)) {
-        entry.hash = hash;
-        entry.move = move;
-        entry.score = static_cast<int16_t>(score);
-        entry.eval = static_cast<int16_t>(eval);
-        entry.depth = static_cast<uint8_t>(depth);
-        entry.flag = static_cast<uint8_t>(flag);
-        entry.age = age_;
+    TTBucket& bucket = getBucket(hash);
+    TTSlot* victim = nullptr;
+    TTEntry victim_entry;
+    int victim_score = 0;
+
+    for (TTSlot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t key = slot.key_xor.load(std::memory_order_relaxed) ^ data;
+        TTEntry existing = unpack(key, data);
+
+        // Same position (or an empty slot): always overwrite in place
+        if (key == hash || existing.flag == TT_NONE) {
+            victim = &slot;
+            victim_entry = existing;
+            break;
+        }
+
+        int candidate_score = replacementScore(existing);
+        if (!victim || candidate_score < victim_score) {
+            victim = &slot;
+            victim_entry = existing;
+            victim_score = candidate_score;
+        }
+    }
+
+    if (victim_entry.hash == hash && victim_entry.flag != TT_NONE) {
+        // Keep a deeper entry from this search unless the new one is exact
+        if (flag != TT_EXACT && victim_entry.age == age_ && depth + 2 < victim_entry.depth) {
+            return;
+        }
+
+        // Preserve the known best move when the new result has none
+        if (move == Move::NO_MOVE) {
+            move = victim_entry.move;
+        }
     }
+
+    uint64_t data = pack(move, score, eval, depth, flag, age_);
+    victim->key_xor.store(hash ^ data, std::memory_order_relaxed);
+    victim->data.store(data, std::memory_order_relaxed);
 }
 
-TTEntry* TranspositionTable::probe(uint64_t hash) {
-    size_t index = getIndex(hash);
-    TTEntry& entry = table_[index];
-    
-    return (entry.hash == hash) ? &entry : nullptr;
+bool TranspositionTable::probe(uint64_t hash, TTEntry& entry) const {
+    const TTBucket& bucket = getBucket(hash);
+
+    for (const TTSlot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.key_xor.load(std::memory_order_relaxed) ^ data) != hash) {
+            continue;
+        }
+
+        entry = unpack(hash, data);
+        if (entry.flag != TT_NONE) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
-void TranspositionTable::clear() {
-    std::memset(table_.get(), 0, table_size_ * sizeof(TTEntry));
+void TranspositionTable::clear(int threads) {
+    // Nothing probes the table meanwhile, so plain stores do. On a fresh
+    // table each thread also first-touches its slice, which spreads the
+    // pages over the NUMA nodes the threads run on.
+    size_t bytes = bucket_count_ * sizeof(TTBucket);
+    threads = bytes >= PARALLEL_CLEAR_BYTES ? std::max(1, threads) : 1;
+    size_t chunk = (bucket_count_ + threads - 1) / threads;
+
+    auto clearRange = [this](size_t begin, size_t end) {
+        std::memset(static_cast<void*>(&table_[begin]), 0, (end - begin) * sizeof(TTBucket));
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) {
+        size_t begin = std::min(bucket_count_, t * chunk);
+        workers.emplace_back(clearRange, begin, std::min(bucket_count_, begin + chunk));
+    }
+    clearRange(0, std::min(bucket_count_, chunk));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
     age_ = 0;
 }
 
-void TranspositionTable::prefetch(uint64_t hash) {
-    // Prefetch the cache line containing the hash entry
-    size_t index = getIndex(hash);
-    __builtin_prefetch(&table_[index], 0, 3);
+void TranspositionTable::prefetch(uint64_t hash) const {
+    // Prefetch the cache line holding the whole bucket
+    __builtin_prefetch(&getBucket(hash), 0, 3);
 }
 
 int TranspositionTable::getHashfull() const {
-    // Sample 1000 entries to estimate how full the table is
+    // Sample the first 1000 slots and count entries written by this search
     int count = 0;
-    int sample_size = std::min(static_cast<size_t>(1000), table_size_);
-    
-    for (int i = 0; i < sample_size; ++i) {
-        if (table_[i].hash != 0) {
-            count++;
+    size_t sample_buckets = std::min(static_cast<size_t>(1000 / TT_BUCKET_SIZE), bucket_count_);
+
+    for (size_t i = 0; i < sample_buckets; ++i) {
+        for (const TTSlot& slot : table_[i].slots) {
+            TTEntry entry = unpack(0, slot.data.load(std::memory_order_relaxed));
+            if (entry.flag != TT_NONE && entry.age == age_) {
+                count++;
+            }
         }
     }
-    
-    return (count * 1000) / sample_size;
-}
 
-bool TranspositionTable::shouldReplace(const TTEntry& existing, int depth, uint8_t new_age) const {
-    // Always replace if entry is from older search
-    if (existing.age != new_age) {
-        return true;
-    }
-    
-    // Replace if new entry has greater depth
-    return depth >= existing.depth;
-}
\ No newline at end of file
+    return static_cast<int>((count * 1000) / (sample_buckets * TT_BUCKET_SIZE));
+}
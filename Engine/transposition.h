@@ -4,7 +4,10 @@
 #include "types.h"
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <cstdlib>
 
+// Decoded view of a table entry, returned by value from probe()
 struct TTEntry {
     uint64_t hash;
     Move move;
@@ -13,37 +16,75 @@ struct TTEntry {
     uint8_t depth;
     uint8_t flag;
     uint8_t age;
-    
-    TTEntry() : hash(0), move(Move::NO_MOVE), score(0), eval(0), depth(0), flag(TT_NONE), age(0) {}
+
+    TTEntry() : hash(0), move(Move::NO_MOVE), score(0), eval(VALUE_NONE), depth(0), flag(TT_NONE), age(0) {}
+};
+
+// Packed 16-byte slot. The data word holds move/score/eval/depth/flag/age and
+// the key word is stored XOR-ed with it (lockless hashing), so a slot torn by
+// concurrent writers fails verification instead of returning mixed data.
+struct TTSlot {
+    std::atomic<uint64_t> key_xor{0};
+    std::atomic<uint64_t> data{0};
+};
+
+// Four slots per 64-byte cache line; a probe touches a single line
+constexpr int TT_BUCKET_SIZE = 4;
+
+struct alignas(64) TTBucket {
+    TTSlot slots[TT_BUCKET_SIZE];
+};
+
+static_assert(sizeof(TTSlot) == 16, "TTSlot must be 16 bytes");
+static_assert(sizeof(TTBucket) == 64, "TTBucket must fill one cache line");
+
+// Frees the table's aligned allocation
+struct AlignedFree {
+    void operator()(void* ptr) const { std::free(ptr); }
 };
 
 class TranspositionTable {
 public:
-    TranspositionTable(int size_mb);
+    // threads only speeds up the initial clear
+    TranspositionTable(int size_mb, int threads = 1);
     ~TranspositionTable();
-    
-    void store(uint64_t hash, int depth, int score, TTFlag flag, Move move, int eval = 0);
-    TTEntry* probe(uint64_t hash);
-    
-    void clear();
-    void prefetch(uint64_t hash);
-    
+
+    // Reallocate to size_mb and clear. Not thread-safe: no search may run.
+    void resize(int size_mb, int threads = 1);
+
+    // eval is the node's static evaluation, VALUE_NONE when unknown
+    void store(uint64_t hash, int depth, int score, TTFlag flag, Move move, int eval = VALUE_NONE);
+    bool probe(uint64_t hash, TTEntry& entry) const;
+
+    // Zero the table, split over threads. Not thread-safe: no search may run.
+    void clear(int threads = 1);
+    void prefetch(uint64_t hash) const;
+
     int getHashfull() const;
-    size_t size() const { return table_size_; }
-    
-    void newSearch() { age_++; }
-    
+    size_t size() const { return bucket_count_ * TT_BUCKET_SIZE; }
+
+    void newSearch() { age_ = (age_ + 1) & AGE_MASK; }
+
 private:
-    std::unique_ptr<TTEntry[]> table_;
-    size_t table_size_;
-    uint64_t table_mask_;
+    static constexpr uint8_t AGE_MASK = 0x3F;  // 6 bits next to the 2-bit flag
+
+    // Tables of at least this size are cleared on several threads
+    static constexpr size_t PARALLEL_CLEAR_BYTES = 64 * 1024 * 1024;
+
+    std::unique_ptr<TTBucket[], AlignedFree> table_;
+    size_t bucket_count_;
+    uint64_t bucket_mask_;
     uint8_t age_;
-    
-    size_t getIndex(uint64_t hash) const {
-        return hash & table_mask_;
+
+    TTBucket& getBucket(uint64_t hash) const {
+        return table_[hash & bucket_mask_];
     }
-    
-    bool shouldReplace(const TTEntry& existing, int depth, uint8_t new_age) const;
+
+    static uint64_t pack(Move move, int score, int eval, int depth, TTFlag flag, uint8_t age);
+    static TTEntry unpack(uint64_t hash, uint64_t data);
+
+    // Lower is a better victim: shallow entries from old searches go first
+    int replacementScore(const TTEntry& entry) const;
 };
 
-#endif // TRANSPOSITION_H
\ No newline at end of file
+#endif // TRANSPOSITION_H
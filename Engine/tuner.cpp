@@ -0,0 +1,698 @@
+#include "tuner.h"
+#include "datagen.h"
+#include "evaluation.h"
+#include "see.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // One group of weights in eval_params.h, written as <name>_MG / <name>_EG
+    struct Term
+    {
+        const char *name;
+        const int *mg;
+        const int *eg;
+        int size;             // 0 for a scalar
+        const char *comment;  // Section comment written before the term
+    };
+
+    // Same order as eval_params.h; TermId indexes this table
+    const Term TERMS[] = {
+        {"PIECE_VALUES", EvalParams::PIECE_VALUES_MG, EvalParams::PIECE_VALUES_EG, 6, "Material: P, N, B, R, Q, K"},
+        {"PST_PAWN", EvalParams::PST_PAWN_MG, EvalParams::PST_PAWN_EG, 64, "Piece-square tables, indexed by square (a1 = 0)"},
+        {"PST_KNIGHT", EvalParams::PST_KNIGHT_MG, EvalParams::PST_KNIGHT_EG, 64, nullptr},
+        {"PST_BISHOP", EvalParams::PST_BISHOP_MG, EvalParams::PST_BISHOP_EG, 64, nullptr},
+        {"PST_ROOK", EvalParams::PST_ROOK_MG, EvalParams::PST_ROOK_EG, 64, nullptr},
+        {"PST_QUEEN", EvalParams::PST_QUEEN_MG, EvalParams::PST_QUEEN_EG, 64, nullptr},
+        {"PST_KING", EvalParams::PST_KING_MG, EvalParams::PST_KING_EG, 64, nullptr},
+        {"DOUBLED_PAWN", &EvalParams::DOUBLED_PAWN_MG, &EvalParams::DOUBLED_PAWN_EG, 0, "Pawn structure, per pawn; passed pawns by relative rank"},
+        {"ISOLATED_PAWN", &EvalParams::ISOLATED_PAWN_MG, &EvalParams::ISOLATED_PAWN_EG, 0, nullptr},
+        {"PASSED_PAWN", EvalParams::PASSED_PAWN_MG, EvalParams::PASSED_PAWN_EG, 8, nullptr},
+        {"MOBILITY", EvalParams::MOBILITY_MG, EvalParams::MOBILITY_EG, 4, "Mobility per attacked square not occupied by own pieces: N, B, R, Q"},
+        {"KING_BACK_RANK", &EvalParams::KING_BACK_RANK_MG, &EvalParams::KING_BACK_RANK_EG, 0, "King safety, only while phase > 8: king on its back rank, pawns next to the king"},
+        {"KING_SHIELD", &EvalParams::KING_SHIELD_MG, &EvalParams::KING_SHIELD_EG, 0, nullptr},
+        {"KING_ZONE_ATTACK", EvalParams::KING_ZONE_ATTACK_MG, EvalParams::KING_ZONE_ATTACK_EG, 4, "King zone (king and adjacent squares) attacks by enemy N, B, R, Q, per attacked square"},
+    };
+
+    enum TermId
+    {
+        T_MATERIAL,
+        T_PST,  // + piece type
+        T_DOUBLED = T_PST + 6,
+        T_ISOLATED,
+        T_PASSED,
+        T_MOBILITY,
+        T_BACK_RANK,
+        T_SHIELD,
+        T_KING_ZONE,
+        TERM_COUNT
+    };
+
+    static_assert(sizeof(TERMS) / sizeof(TERMS[0]) == TERM_COUNT, "TERMS and TermId out of sync");
+
+    constexpr int REPORT_EPOCHS = 100;
+    constexpr double LEARNING_RATE = 1.0;  // Centipawns per step, decayed linearly to a tenth
+    constexpr double ADAM_BETA1 = 0.9;
+    constexpr double ADAM_BETA2 = 0.999;
+
+    // Weights as one flat vector; every index has a middlegame and an endgame value
+    struct Params
+    {
+        std::vector<int> offset;  // [TermId] first index of the term
+        std::vector<double> mg;
+        std::vector<double> eg;
+
+        Params() : offset(TERM_COUNT)
+        {
+            for (int t = 0; t < TERM_COUNT; ++t)
+            {
+                offset[t] = static_cast<int>(mg.size());
+                for (int i = 0; i < std::max(1, TERMS[t].size); ++i)
+                {
+                    mg.push_back(TERMS[t].mg[i]);
+                    eg.push_back(TERMS[t].eg[i]);
+                }
+            }
+        }
+
+        int size() const { return static_cast<int>(mg.size()); }
+        int index(int term, int i = 0) const { return offset[term] + i; }
+    };
+
+    // Positions as a sparse trace, structure of arrays: position p owns the
+    // entries [begin[p], begin[p + 1])
+    struct Dataset
+    {
+        std::vector<uint32_t> begin{0};
+        std::vector<uint16_t> index;
+        std::vector<int16_t> coeff;
+        std::vector<float> phase;   // Middlegame share, phase / TOTAL_PHASE
+        std::vector<float> result;  // White's score: 1, 0.5 or 0
+
+        size_t size() const { return result.size(); }
+    };
+
+    // Coefficient of every weight in the evaluation of board, white minus
+    // black, mirroring Evaluation::evaluate term by term. Returns the phase.
+    int buildTrace(const Board &board, const Params &params, std::vector<int> &coeff)
+    {
+        std::fill(coeff.begin(), coeff.end(), 0);
+        int material_phase = 0;
+
+        AttackInfo attacks;
+        attacks.computeAttacks(board);
+
+        for (Color color : {Color::WHITE, Color::BLACK})
+        {
+            int sign = (color == Color::WHITE) ? 1 : -1;
+            int flip = (color == Color::WHITE) ? 0 : 56;
+
+            // Material and piece-square tables
+            Bitboard pieces = board.us(color);
+            while (pieces)
+            {
+                Square sq = pieces.pop();
+                int type = static_cast<int>(board.at(sq).type());
+                coeff[params.index(T_MATERIAL, type)] += sign;
+                coeff[params.index(T_PST + type, sq.index() ^ flip)] += sign;
+                material_phase += Evaluation::PHASE_VALUES[type];
+            }
+
+            // Pawn structure
+            Bitboard own_pawns = board.pieces(PieceType::PAWN, color);
+            Bitboard enemy_pawns = board.pieces(PieceType::PAWN, ~color);
+            Bitboard pawns = own_pawns;
+            while (pawns)
+            {
+                Square sq = pawns.pop();
+                int file = static_cast<int>(sq.file());
+                int rank = static_cast<int>(sq.rank());
+
+                Bitboard adjacent(0);
+                if (file > 0)
+                {
+                    adjacent |= Bitboard(chess::File(file - 1));
+                }
+                if (file < 7)
+                {
+                    adjacent |= Bitboard(chess::File(file + 1));
+                }
+
+                if ((own_pawns & Bitboard(sq.file())).count() > 1)
+                {
+                    coeff[params.index(T_DOUBLED)] += sign;
+                }
+                if ((own_pawns & adjacent).empty())
+                {
+                    coeff[params.index(T_ISOLATED)] += sign;
+                }
+
+                bool passed = true;
+                Bitboard blockers = enemy_pawns & (adjacent | Bitboard(sq.file()));
+                while (blockers && passed)
+                {
+                    int blocker_rank = blockers.pop() >> 3;
+                    passed = (color == Color::WHITE) ? blocker_rank <= rank : blocker_rank >= rank;
+                }
+                if (passed)
+                {
+                    coeff[params.index(T_PASSED, (color == Color::WHITE) ? rank : 7 - rank)] += sign;
+                }
+            }
+
+            // Mobility and attacks on the enemy king zone
+            Bitboard targets = ~board.us(color);
+            Square enemy_king = board.kingSq(~color);
+            Bitboard zone = chess::attacks::king(enemy_king) | Bitboard::fromSquare(enemy_king);
+            for (PieceType piece_type : {PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN})
+            {
+                int index = static_cast<int>(piece_type) - 1;
+                Bitboard pieces = board.pieces(piece_type, color);
+                while (pieces)
+                {
+                    Bitboard piece_attacks = attacks.piece_attacks[pieces.pop()];
+                    coeff[params.index(T_MOBILITY, index)] += sign * (piece_attacks & targets).count();
+                    // A penalty for the attacked side
+                    coeff[params.index(T_KING_ZONE, index)] -= sign * (piece_attacks & zone).count();
+                }
+            }
+        }
+
+        int phase = std::clamp(Evaluation::TOTAL_PHASE - material_phase, 0, Evaluation::TOTAL_PHASE);
+
+        // King safety
+        if (phase > 8)
+        {
+            for (Color color : {Color::WHITE, Color::BLACK})
+            {
+                int sign = (color == Color::WHITE) ? 1 : -1;
+                Square king_sq = board.kingSq(color);
+                chess::Rank back_rank = (color == Color::WHITE) ? chess::Rank::RANK_1 : chess::Rank::RANK_8;
+
+                if (king_sq.rank() == back_rank)
+                {
+                    coeff[params.index(T_BACK_RANK)] += sign;
+                }
+                coeff[params.index(T_SHIELD)] += sign * (chess::attacks::king(king_sq) & board.pieces(PieceType::PAWN, color)).count();
+            }
+        }
+
+        return phase;
+    }
+
+    // The trace evaluated with the current weights in integer arithmetic,
+    // which must reproduce Evaluation::evaluate exactly
+    int traceEval(const std::vector<int> &coeff, int phase, const Params &params)
+    {
+        int mg = 0, eg = 0;
+        for (int i = 0; i < params.size(); ++i)
+        {
+            mg += coeff[i] * static_cast<int>(params.mg[i]);
+            eg += coeff[i] * static_cast<int>(params.eg[i]);
+        }
+        return (mg * phase + eg * (Evaluation::TOTAL_PHASE - phase)) / Evaluation::TOTAL_PHASE;
+    }
+
+    // Game result from the text after the FEN, white's point of view
+    bool parseResult(const std::string &text, float &result)
+    {
+        if (text.find("1/2-1/2") != std::string::npos)
+        {
+            result = 0.5f;
+            return true;
+        }
+        if (text.find("1-0") != std::string::npos)
+        {
+            result = 1.0f;
+            return true;
+        }
+        if (text.find("0-1") != std::string::npos)
+        {
+            result = 0.0f;
+            return true;
+        }
+
+        // [1.0] style, or a bare score as the last token
+        size_t bracket = text.find('[');
+        size_t last = text.find_last_not_of(" \t;\"]");
+        size_t start = bracket != std::string::npos ? bracket + 1
+                       : last != std::string::npos  ? text.find_last_of(" \t\"", last) + 1
+                                                    : std::string::npos;
+        if (start == std::string::npos || start >= text.size())
+        {
+            return false;
+        }
+
+        char *end = nullptr;
+        double value = std::strtod(text.c_str() + start, &end);
+        if (end == text.c_str() + start || value < 0.0 || value > 1.0)
+        {
+            return false;
+        }
+        result = static_cast<float>(value);
+        return true;
+    }
+
+    // Splits "<fen> <result...>"; the move counters are optional
+    bool parseLine(const std::string &line, std::string &fen, float &result)
+    {
+        std::istringstream iss(line);
+        std::string field;
+        fen.clear();
+        for (int i = 0; i < 4; ++i)
+        {
+            if (!(iss >> field))
+            {
+                return false;
+            }
+            fen += (i > 0 ? " " : "") + field;
+        }
+
+        // Half-move and full-move counters, when present
+        for (int i = 0; i < 2; ++i)
+        {
+            std::streampos pos = iss.tellg();
+            if (!(iss >> field) || field.find_first_not_of("0123456789") != std::string::npos)
+            {
+                iss.clear();
+                iss.seekg(pos);
+                break;
+            }
+            fen += " " + field;
+        }
+
+        std::string rest;
+        std::getline(iss, rest);
+        return parseResult(rest, result);
+    }
+
+    // Texel's quiet criterion: the side to move is not in check and has no
+    // capture that wins material
+    bool isQuiet(const Board &board)
+    {
+        if (board.inCheck())
+        {
+            return false;
+        }
+
+        chess::Movelist captures;
+        chess::movegen::legalmoves<chess::movegen::MoveGenType::CAPTURE>(captures, board);
+        for (const Move &move : captures)
+        {
+            if (move.typeOf() == Move::PROMOTION || see(board, move, 1))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Labeled positions from an EPD file or a packed self-play file
+    class PositionSource
+    {
+    public:
+        explicit PositionSource(const std::string &path)
+            : file_(path, std::ios::binary)
+        {
+            if (isPackedFile(path))
+            {
+                packed_ = std::make_unique<PackedGameReader>(file_);
+            }
+        }
+
+        bool isOpen() const { return file_.is_open(); }
+        bool isPacked() const { return packed_ != nullptr; }
+
+        // False at the end of the input; readable is cleared for an entry
+        // that doesn't parse
+        bool next(Board &board, float &result, bool &readable)
+        {
+            readable = true;
+            if (packed_)
+            {
+                Move move;
+                int score;
+                return packed_->next(board, move, score, result);
+            }
+
+            std::string line;
+            while (std::getline(file_, line))
+            {
+                if (!line.empty() && line.back() == '\r')
+                {
+                    line.pop_back();
+                }
+                if (line.empty() || line[0] == '#')
+                {
+                    continue;
+                }
+                readable = parseLine(line, fen_, result) && board.setFen(fen_);
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        std::ifstream file_;
+        std::unique_ptr<PackedGameReader> packed_;
+        std::string fen_;
+    };
+
+    bool loadDataset(const std::string &path, const Params &params, Dataset &data)
+    {
+        PositionSource source(path);
+        if (!source.isOpen())
+        {
+            std::cerr << "Could not open training file: " << path << std::endl;
+            return false;
+        }
+
+        Evaluation evaluation;
+        std::vector<int> coeff(params.size());
+        size_t entries = 0, unreadable = 0, noisy = 0, mismatches = 0;
+
+        Board board;
+        float result;
+        bool readable;
+        while (source.next(board, result, readable))
+        {
+            ++entries;
+            if (!readable)
+            {
+                ++unreadable;
+                continue;
+            }
+            if (!isQuiet(board))
+            {
+                ++noisy;
+                continue;
+            }
+
+            int phase = buildTrace(board, params, coeff);
+
+            int expected = evaluation.evaluate(board);
+            if (board.sideToMove() == Color::BLACK)
+            {
+                expected = -expected;
+            }
+            if (traceEval(coeff, phase, params) != expected)
+            {
+                if (++mismatches <= 5)
+                {
+                    std::cerr << "Trace mismatch (" << traceEval(coeff, phase, params) << " vs "
+                              << expected << "): " << board.getFen() << std::endl;
+                }
+                continue;
+            }
+
+            for (int i = 0; i < params.size(); ++i)
+            {
+                if (coeff[i] != 0)
+                {
+                    data.index.push_back(static_cast<uint16_t>(i));
+                    data.coeff.push_back(static_cast<int16_t>(coeff[i]));
+                }
+            }
+            data.begin.push_back(static_cast<uint32_t>(data.index.size()));
+            data.phase.push_back(static_cast<float>(phase) / Evaluation::TOTAL_PHASE);
+            data.result.push_back(result);
+
+            if (data.size() % 1000000 == 0)
+            {
+                std::cerr << "Loaded " << data.size() << " positions" << std::endl;
+            }
+        }
+
+        std::cerr << "Read " << entries << (source.isPacked() ? " packed" : " EPD") << " positions: "
+                  << data.size() << " quiet, " << noisy << " noisy, " << unreadable << " unreadable" << std::endl;
+
+        if (mismatches > 0)
+        {
+            std::cerr << mismatches << " positions where the trace disagrees with Evaluation::evaluate;"
+                      << " tuner.cpp must trace every evaluation term" << std::endl;
+            return false;
+        }
+        return data.size() > 0;
+    }
+
+    // Runs fn(thread, begin, end) over contiguous slices of [0, count)
+    template <typename Fn>
+    void parallelFor(int threads, size_t count, Fn fn)
+    {
+        std::vector<std::thread> workers;
+        size_t chunk = (count + threads - 1) / threads;
+        for (int t = 0; t < threads; ++t)
+        {
+            size_t begin = std::min(count, t * chunk);
+            size_t end = std::min(count, begin + chunk);
+            workers.emplace_back(fn, t, begin, end);
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    double linearEval(const Dataset &data, const Params &params, size_t p)
+    {
+        double mg = 0.0, eg = 0.0;
+        for (uint32_t e = data.begin[p]; e < data.begin[p + 1]; ++e)
+        {
+            mg += data.coeff[e] * params.mg[data.index[e]];
+            eg += data.coeff[e] * params.eg[data.index[e]];
+        }
+        return mg * data.phase[p] + eg * (1.0 - data.phase[p]);
+    }
+
+    double sigmoid(double k, double eval)
+    {
+        return 1.0 / (1.0 + std::exp(-k * eval * std::log(10.0) / 400.0));
+    }
+
+    // Mean squared error between the results and the predicted scores
+    double meanError(const Dataset &data, const Params &params, double k, int threads)
+    {
+        std::vector<double> sums(threads, 0.0);
+        parallelFor(threads, data.size(), [&](int t, size_t begin, size_t end) {
+            double sum = 0.0;
+            for (size_t p = begin; p < end; ++p)
+            {
+                double error = data.result[p] - sigmoid(k, linearEval(data, params, p));
+                sum += error * error;
+            }
+            sums[t] = sum;
+        });
+
+        double total = 0.0;
+        for (double sum : sums)
+        {
+            total += sum;
+        }
+        return total / data.size();
+    }
+
+    // Scaling constant of the sigmoid that best fits the starting weights
+    double fitK(const Dataset &data, const Params &params, int threads)
+    {
+        const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+        double lo = 0.0, hi = 5.0;
+        double a = hi - ratio * (hi - lo), b = lo + ratio * (hi - lo);
+        double fa = meanError(data, params, a, threads), fb = meanError(data, params, b, threads);
+
+        for (int i = 0; i < 40; ++i)
+        {
+            if (fa < fb)
+            {
+                hi = b;
+                b = a;
+                fb = fa;
+                a = hi - ratio * (hi - lo);
+                fa = meanError(data, params, a, threads);
+            }
+            else
+            {
+                lo = a;
+                a = b;
+                fa = fb;
+                b = lo + ratio * (hi - lo);
+                fb = meanError(data, params, b, threads);
+            }
+        }
+        return (lo + hi) / 2.0;
+    }
+
+    // Gradient of the mean error with respect to every weight
+    void gradient(const Dataset &data, const Params &params, double k, int threads,
+                  std::vector<double> &grad_mg, std::vector<double> &grad_eg)
+    {
+        int size = params.size();
+        std::vector<std::vector<double>> local(threads, std::vector<double>(2 * size, 0.0));
+
+        parallelFor(threads, data.size(), [&](int t, size_t begin, size_t end) {
+            double *g = local[t].data();
+            for (size_t p = begin; p < end; ++p)
+            {
+                double s = sigmoid(k, linearEval(data, params, p));
+                double d = (s - data.result[p]) * s * (1.0 - s);
+                double d_mg = d * data.phase[p];
+                double d_eg = d * (1.0 - data.phase[p]);
+                for (uint32_t e = data.begin[p]; e < data.begin[p + 1]; ++e)
+                {
+                    g[data.index[e]] += d_mg * data.coeff[e];
+                    g[size + data.index[e]] += d_eg * data.coeff[e];
+                }
+            }
+        });
+
+        // Constant factors 2k ln(10) / 400 are left out; Adam is scale-invariant
+        std::fill(grad_mg.begin(), grad_mg.end(), 0.0);
+        std::fill(grad_eg.begin(), grad_eg.end(), 0.0);
+        for (const auto &g : local)
+        {
+            for (int i = 0; i < size; ++i)
+            {
+                grad_mg[i] += g[i] / data.size();
+                grad_eg[i] += g[size + i] / data.size();
+            }
+        }
+    }
+
+    void writeValues(std::ostream &out, const std::string &name, const std::vector<double> &values,
+                     int first, int size)
+    {
+        if (size == 0)
+        {
+            out << "    constexpr int " << name << " = " << std::lround(values[first]) << ";\n";
+            return;
+        }
+
+        out << "    constexpr int " << name << "[" << size << "] = {";
+        if (size <= 8)
+        {
+            for (int i = 0; i < size; ++i)
+            {
+                out << (i > 0 ? ", " : "") << std::lround(values[first + i]);
+            }
+            out << "};\n";
+            return;
+        }
+
+        for (int i = 0; i < size; ++i)
+        {
+            out << (i % 8 == 0 ? "\n        " : " ") << std::setw(3) << std::lround(values[first + i])
+                << (i + 1 < size ? "," : "\n");
+        }
+        out << "    };\n\n";
+    }
+
+    bool writeParams(const std::string &path, const Params &params)
+    {
+        std::ofstream out(path);
+        if (!out.is_open())
+        {
+            std::cerr << "Could not write " << path << std::endl;
+            return false;
+        }
+
+        out << "#ifndef EVAL_PARAMS_H\n"
+               "#define EVAL_PARAMS_H\n"
+               "\n"
+               "// Evaluation weights in centipawns, from white's point of view. Every term\n"
+               "// has a middlegame and an endgame weight. Regenerated by `chess_engine tune`\n"
+               "// (see tuner.h); hand edits survive only until the next tuning run.\n"
+               "namespace EvalParams {\n";
+
+        bool blank = true;
+        for (int t = 0; t < TERM_COUNT; ++t)
+        {
+            const Term &term = TERMS[t];
+            if (term.comment)
+            {
+                out << (blank ? "" : "\n") << "    // " << term.comment << "\n";
+            }
+            std::string name = term.name;
+            writeValues(out, name + "_MG", params.mg, params.offset[t], term.size);
+            writeValues(out, name + "_EG", params.eg, params.offset[t], term.size);
+            blank = term.size > 8;
+        }
+
+        out << "}\n\n#endif // EVAL_PARAMS_H\n";
+        return static_cast<bool>(out);
+    }
+}
+
+int runTune(const std::string &path, int epochs, int threads, const std::string &output)
+{
+    if (threads <= 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    Params params;
+    Dataset data;
+    auto start = std::chrono::steady_clock::now();
+
+    std::cerr << "Tuning " << params.size() << " weights from " << path << " with "
+              << threads << " thread(s)" << std::endl;
+    if (!loadDataset(path, params, data))
+    {
+        return 1;
+    }
+
+    double k = fitK(data, params, threads);
+    std::cerr << "K = " << std::setprecision(6) << k << ", starting error "
+              << meanError(data, params, k, threads) << std::endl;
+
+    int size = params.size();
+    std::vector<double> grad_mg(size), grad_eg(size);
+    std::vector<double> m_mg(size, 0.0), m_eg(size, 0.0), v_mg(size, 0.0), v_eg(size, 0.0);
+
+    for (int epoch = 1; epoch <= epochs; ++epoch)
+    {
+        gradient(data, params, k, threads, grad_mg, grad_eg);
+
+        double rate = LEARNING_RATE * (1.0 - 0.9 * (epoch - 1) / epochs);
+        double correction1 = 1.0 - std::pow(ADAM_BETA1, epoch);
+        double correction2 = 1.0 - std::pow(ADAM_BETA2, epoch);
+        auto step = [&](double &param, double grad, double &m, double &v) {
+            m = ADAM_BETA1 * m + (1.0 - ADAM_BETA1) * grad;
+            v = ADAM_BETA2 * v + (1.0 - ADAM_BETA2) * grad * grad;
+            param -= rate * (m / correction1) / (std::sqrt(v / correction2) + 1e-12);
+        };
+        for (int i = 0; i < size; ++i)
+        {
+            if (grad_mg[i] != 0.0 || m_mg[i] != 0.0)
+            {
+                step(params.mg[i], grad_mg[i], m_mg[i], v_mg[i]);
+            }
+            if (grad_eg[i] != 0.0 || m_eg[i] != 0.0)
+            {
+                step(params.eg[i], grad_eg[i], m_eg[i], v_eg[i]);
+            }
+        }
+
+        if (epoch % REPORT_EPOCHS == 0 || epoch == epochs)
+        {
+            int64_t ms = std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - start).count();
+            std::cerr << "Epoch " << epoch << " error " << std::setprecision(6)
+                      << meanError(data, params, k, threads) << " (" << ms << " ms)" << std::endl;
+            writeParams(output, params);
+        }
+    }
+
+    if (!writeParams(output, params))
+    {
+        return 1;
+    }
+    std::cerr << "Wrote " << output << std::endl;
+    return 0;
+}
@@ -0,0 +1,22 @@
+#ifndef TUNER_H
+#define TUNER_H
+
+#include <string>
+
+constexpr int TUNE_DEFAULT_EPOCHS = 1000;
+constexpr const char* TUNE_DEFAULT_OUTPUT = "eval_params_tuned.h";
+
+// Offline Texel tuner for the hand-written evaluation (eval_params.h).
+// Streams labeled positions from a packed self-play file (datagen.h) or an
+// EPD file, one "<fen> <result>" per line with the result from white's
+// point of view as 1-0 / 0-1 / 1/2-1/2, c9 "1-0"; or [1.0] / [0.5] / [0.0].
+// Positions in check or with a winning capture are dropped. Every kept
+// position is reduced to a sparse linear trace of the evaluation terms,
+// checked against Evaluation::evaluate, and the weights are fitted to the
+// results by full-batch Adam on the sigmoid error, split over threads
+// (0 = all cores). The fitted weights are written
+// to output in eval_params.h's layout, also every 100 epochs.
+int runTune(const std::string& path, int epochs = TUNE_DEFAULT_EPOCHS, int threads = 0,
+            const std::string& output = TUNE_DEFAULT_OUTPUT);
+
+#endif // TUNER_H
@@ -3,6 +3,9 @@
 
 #include <cstdint>
 #include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <vector>
 #include "chess.hpp"
 
 // Type aliases for convenience
@@ -19,12 +22,18 @@ constexpr int MAX_DEPTH = 64;
 constexpr int MAX_PLY = 128;
 constexpr int MATE_VALUE = 30000;
 constexpr int MATE_IN_MAX_PLY = MATE_VALUE - MAX_PLY;
+constexpr int VALUE_NONE = MATE_VALUE + 1;  // No static eval (side to move in check)
+
+// Tablebase wins score below every mate the search can find
+constexpr int TB_WIN_SCORE = MATE_IN_MAX_PLY - 1;
+constexpr int TB_WIN_IN_MAX_PLY = TB_WIN_SCORE - MAX_PLY;
 
 // Hash table constants
 constexpr int DEFAULT_HASH_SIZE_MB = 64;
 constexpr uint64_t HASH_SIZE_BYTES = DEFAULT_HASH_SIZE_MB * 1024 * 1024;
 
 // Time management
+constexpr int DEFAULT_MOVE_OVERHEAD_MS = 30;
 using TimePoint = std::chrono::steady_clock::time_point;
 using Duration = std::chrono::milliseconds;
 
@@ -59,30 +68,90 @@ struct PVLine {
     }
 };
 
+// Limits given by one `go` command; zero means "not set"
+struct SearchLimits {
+    int depth = 0;
+    int movetime = 0;
+    int wtime = 0;
+    int btime = 0;
+    int winc = 0;
+    int binc = 0;
+    int movestogo = 0;
+    uint64_t nodes = 0;  // Main-thread node budget, 0 = none (deterministic with Threads 1)
+    bool infinite = false;
+    bool ponder = false;
+    std::vector<Move> searchmoves;  // Empty: all legal moves
+};
+
 // Search information
 struct SearchInfo {
+    // Clock polling bounds, in nodes between two steady_clock reads
+    static constexpr int MIN_POLL_INTERVAL = 256;
+    static constexpr int MAX_POLL_INTERVAL = 16384;
+
     int depth = 0;
     int seldepth = 0;
-    int nodes = 0;
+    std::atomic<uint64_t> nodes{0};  // Written by the owning thread, read by the reporter
     int time_ms = 0;
-    bool stopped = false;
+    uint64_t tbhits = 0;
+    std::atomic<bool> stopped{false};
     TimePoint start_time;
-    Duration time_limit{0};
+    std::atomic<int64_t> time_limit{0};  // Hard limit in ms after start_time, 0 = none
+    uint64_t node_limit = 0;             // Stop after this many nodes, 0 = none
+    uint64_t next_poll = 0;
     
     void reset() {
-        depth = seldepth = nodes = time_ms = 0;
+        depth = seldepth = time_ms = 0;
+        nodes = 0;
+        tbhits = 0;
         stopped = false;
+        next_poll = MIN_POLL_INTERVAL;
         start_time = std::chrono::steady_clock::now();
     }
     
+    // Single writer, so a relaxed load/store pair is enough (no locked add)
+    void count_node() {
+        nodes.store(nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    
+    void update_seldepth(int ply) {
+        if (ply > seldepth) {
+            seldepth = ply;
+        }
+    }
+    
+    // Cheap enough to call at every node: a relaxed load of the stop flag
     bool should_stop() const {
-        if (stopped) return true;
-        if (time_limit.count() > 0) {
-            auto elapsed = std::chrono::duration_cast<Duration>(
-                std::chrono::steady_clock::now() - start_time);
-            return elapsed >= time_limit;
+        return stopped.load(std::memory_order_relaxed);
+    }
+    
+    // Called once per node; only reads the clock every few thousand nodes,
+    // polling more often as the deadline approaches
+    void check_time() {
+        // Atomic so that ponderhit can arm the limit of a running search
+        int64_t limit = time_limit.load(std::memory_order_relaxed);
+        uint64_t count = nodes.load(std::memory_order_relaxed);
+        if (node_limit > 0 && count >= node_limit) {
+            stopped.store(true, std::memory_order_relaxed);
+            return;
+        }
+        if (limit <= 0 || count < next_poll) {
+            return;
+        }
+        
+        auto elapsed = std::chrono::duration_cast<Duration>(
+            std::chrono::steady_clock::now() - start_time).count();
+        if (elapsed >= limit) {
+            stopped.store(true, std::memory_order_relaxed);
+            return;
         }
-        return false;
+        
+        // Aim for about one poll per millisecond, and at least four polls
+        // within the time that remains
+        int64_t nodes_per_ms = static_cast<int64_t>(count) / std::max<int64_t>(1, elapsed);
+        int64_t remaining = limit - elapsed;
+        int64_t interval = std::min(nodes_per_ms, nodes_per_ms * remaining / 4);
+        next_poll = count + static_cast<uint64_t>(std::clamp<int64_t>(interval, MIN_POLL_INTERVAL, MAX_POLL_INTERVAL));
     }
 };
 
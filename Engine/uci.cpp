@@ -1,6 +1,8 @@
 #include "uci.h"
-#include <iostream>
-#include <thread>
+#include "perft.h"
+#include "uci_output.h"
+#include <chrono>
+#include <cstdlib>
 
 UCIHandler::UCIHandler(ChessEngine &engine) : engine_(engine) {}
 
@@ -34,6 +36,10 @@ void UCIHandler::processCommand(const std::string &command)
     {
         handleStop();
     }
+    else if (token == "ponderhit")
+    {
+        engine_.ponderHit();
+    }
     else if (token == "quit")
     {
         handleQuit();
@@ -50,26 +56,38 @@ void UCIHandler::processCommand(const std::string &command)
     {
         handleEval();
     }
+    else if (token == "debug")
+    {
+        handleDebug(iss);
+    }
     // Ignore unknown commands
 }
 
 void UCIHandler::handleUCI()
 {
-    std::cout << "id name ChessEngine 1.0" << std::endl;
-    std::cout << "id author AI Assistant" << std::endl;
+    std::ostringstream oss;
+    oss << "id name ChessEngine 1.0\n";
+    oss << "id author AI Assistant\n";
 
     // Options
-    std::cout << "option name Hash type spin default 64 min 1 max 4096" << std::endl;
-    std::cout << "option name Threads type spin default 1 min 1 max 128" << std::endl;
-    std::cout << "option name BookPath type string default " << std::endl;
-    std::cout << "option name SyzygyPath type string default " << std::endl;
-
-    std::cout << "uciok" << std::endl;
+    oss << "option name Hash type spin default 64 min 1 max 4096\n";
+    oss << "option name Threads type spin default 1 min 1 max 128\n";
+    oss << "option name Ponder type check default false\n";
+    oss << "option name MultiPV type spin default 1 min 1 max " << ChessEngine::MAX_MULTI_PV << "\n";
+    oss << "option name Move Overhead type spin default " << DEFAULT_MOVE_OVERHEAD_MS
+        << " min 0 max 5000\n";
+    oss << "option name BookPath type string default \n";
+    oss << "option name SyzygyPath type string default \n";
+    oss << "option name EvalFile type string default \n";
+
+    oss << "uciok";
+    send(oss.str());
 }
 
 void UCIHandler::handleIsReady()
 {
-    std::cout << "readyok" << std::endl;
+    engine_.applyPendingChanges();
+    send("readyok");
 }
 
 void UCIHandler::handleUCINewGame()
@@ -119,53 +137,90 @@ void UCIHandler::handlePosition(std::istringstream &iss)
 void UCIHandler::handleGo(std::istringstream &iss)
 {
     std::string token;
-
-    int depth = 0;
-    int movetime = 0;
-    int wtime = 0, btime = 0;
-    int winc = 0, binc = 0;
-    bool infinite = false;
+    SearchLimits limits;
+    bool searchmoves = false;
 
     while (iss >> token)
     {
-        if (token == "depth")
+        // searchmoves takes every move up to the next keyword
+        if (searchmoves && isMoveToken(token))
+        {
+            Move move = engine_.parseMove(token);
+            if (move != Move::NO_MOVE)
+            {
+                limits.searchmoves.push_back(move);
+            }
+            continue;
+        }
+        searchmoves = false;
+
+        if (token == "perft")
         {
-            iss >> depth;
+            // go perft N runs synchronously, like the perft command
+            handlePerft(iss);
+            return;
+        }
+        else if (token == "depth")
+        {
+            iss >> limits.depth;
         }
         else if (token == "movetime")
         {
-            iss >> movetime;
+            iss >> limits.movetime;
+        }
+        else if (token == "nodes")
+        {
+            iss >> limits.nodes;
         }
         else if (token == "wtime")
         {
-            iss >> wtime;
+            iss >> limits.wtime;
         }
         else if (token == "btime")
         {
-            iss >> btime;
+            iss >> limits.btime;
         }
         else if (token == "winc")
         {
-            iss >> winc;
+            iss >> limits.winc;
         }
         else if (token == "binc")
         {
-            iss >> binc;
+            iss >> limits.binc;
+        }
+        else if (token == "movestogo")
+        {
+            iss >> limits.movestogo;
         }
         else if (token == "infinite")
         {
-            infinite = true;
+            limits.infinite = true;
+        }
+        else if (token == "ponder")
+        {
+            limits.ponder = true;
+        }
+        else if (token == "searchmoves")
+        {
+            searchmoves = true;
         }
     }
 
-    // Start search in separate thread
-    std::thread search_thread([&]()
-                              {
-        Move best_move = engine_.search(depth, movetime, wtime, btime, winc, binc, infinite);
-        
-        std::cout << "bestmove " << moveToString(best_move) << std::endl; });
-
-    search_thread.detach();
+    // Hand the search to the engine's search thread; bestmove is printed
+    // from there once the search ends
+    engine_.startSearch(limits, [this](Move best_move, Move ponder_move)
+                        {
+        std::ostringstream oss;
+        if (debug_ && SEARCH_STATS_ENABLED)
+        {
+            engine_.searchStats().print(oss, "info string ");
+        }
+        oss << "bestmove " << moveToString(best_move);
+        if (ponder_move != Move::NO_MOVE)
+        {
+            oss << " ponder " << moveToString(ponder_move);
+        }
+        send(oss.str()); });
 }
 
 void UCIHandler::handleStop()
@@ -176,6 +231,8 @@ void UCIHandler::handleStop()
 void UCIHandler::handleQuit()
 {
     engine_.stopSearch();
+    engine_.waitForSearch();
+    uciOutput().stop();
     std::exit(0);
 }
 
@@ -187,10 +244,15 @@ void UCIHandler::handleSetOption(std::istringstream &iss)
     if (token != "name")
         return;
 
-    iss >> token; // option name
-    std::string option_name = token;
+    // Option names may contain spaces ("Move Overhead")
+    std::string option_name;
+    while (iss >> token && token != "value")
+    {
+        if (!option_name.empty())
+            option_name += " ";
+        option_name += token;
+    }
 
-    iss >> token; // "value"
     if (token != "value")
         return;
 
@@ -206,6 +268,18 @@ void UCIHandler::handleSetOption(std::istringstream &iss)
         iss >> threads;
         engine_.setThreads(threads);
     }
+    else if (option_name == "MultiPV")
+    {
+        int lines;
+        iss >> lines;
+        engine_.setMultiPV(lines);
+    }
+    else if (option_name == "Move Overhead")
+    {
+        int overhead;
+        iss >> overhead;
+        engine_.setMoveOverhead(overhead);
+    }
     else if (option_name == "BookPath")
     {
         std::string path;
@@ -218,25 +292,92 @@ void UCIHandler::handleSetOption(std::istringstream &iss)
         iss >> path;
         engine_.setTablebases(path);
     }
+    else if (option_name == "EvalFile")
+    {
+        std::string path;
+        iss >> path;
+        engine_.setEvalFile(path);
+    }
 }
 
 void UCIHandler::handlePerft(std::istringstream &iss)
 {
-    int depth;
-    if (iss >> depth)
+    // perft <depth> | perft divide <depth>
+    std::string token;
+    bool divide = false;
+    int depth = 0;
+
+    if (!(iss >> token))
+        return;
+
+    if (token == "divide")
+    {
+        divide = true;
+        if (!(iss >> token))
+            return;
+    }
+
+    depth = std::atoi(token.c_str());
+    if (depth <= 0)
+        return;
+
+    Board board = engine_.getBoard();
+    PerftTable table(PERFT_HASH_MB);
+
+    // perft divide prints its lines itself; keep them after earlier output
+    uciOutput().flush();
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes;
+
+    if (divide)
     {
-        // TODO: Implement perft for move generation testing
-        std::cout << "Perft not implemented yet" << std::endl;
+        nodes = perftDivide(board, depth, &table);
     }
+    else
+    {
+        nodes = perft(board, depth, &table);
+        send("Nodes searched: " + std::to_string(nodes));
+    }
+
+    auto ms = std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - start).count();
+    send("Time: " + std::to_string(ms) + " ms, " +
+                     std::to_string(nodes * 1000 / std::max<int64_t>(1, ms)) + " nps");
 }
 
 void UCIHandler::handleEval()
 {
     int eval = engine_.evaluate();
-    std::cout << "eval: " << eval << " (from "
-              << (engine_.getBoard().sideToMove() == Color::WHITE ? "white" : "black")
-              << "'s perspective)" << std::endl;
-    std::cout << engine_.getAnalysis() << std::endl;
+    std::ostringstream oss;
+    oss << "eval: " << eval << " (from "
+        << (engine_.getBoard().sideToMove() == Color::WHITE ? "white" : "black")
+        << "'s perspective)\n"
+        << engine_.getAnalysis();
+    send(oss.str());
+}
+
+void UCIHandler::handleDebug(std::istringstream &iss)
+{
+    std::string mode;
+    iss >> mode;
+    debug_ = (mode == "on");
+
+    if (debug_ && !SEARCH_STATS_ENABLED)
+    {
+        send("info string search statistics not compiled in (build with STATS=1)");
+    }
+}
+
+bool UCIHandler::isMoveToken(const std::string &token)
+{
+    // Long algebraic: e2e4, e7e8q
+    auto file = [](char c)
+    { return c >= 'a' && c <= 'h'; };
+    auto rank = [](char c)
+    { return c >= '1' && c <= '8'; };
+
+    return (token.size() == 4 || (token.size() == 5 && std::string("qrbn").find(token[4]) != std::string::npos)) &&
+           file(token[0]) && rank(token[1]) && file(token[2]) && rank(token[3]);
 }
 
 std::vector<std::string> UCIHandler::split(const std::string &str, char delimiter)
@@ -251,38 +392,13 @@ std::vector<std::string> UCIHandler::split(const std::string &str, char delimite
     return tokens;
 }
 
-std::string UCIHandler::moveToString(const Move &move)
+void UCIHandler::send(const std::string &text)
 {
-    if (move == Move::NO_MOVE)
-    {
-        return "0000";
-    }
-
-    std::string result = static_cast<std::string>(move.from()) +
-                         static_cast<std::string>(move.to());
-
-    // Handle promotion
-    if (move.typeOf() == Move::PROMOTION)
-    {
-        switch (static_cast<int>(move.promotionType()))
-        {
-        case static_cast<int>(PieceType::QUEEN):
-            result += 'q';
-            break;
-        case static_cast<int>(PieceType::ROOK):
-            result += 'r';
-            break;
-        case static_cast<int>(PieceType::BISHOP):
-            result += 'b';
-            break;
-        case static_cast<int>(PieceType::KNIGHT):
-            result += 'n';
-            break;
-        default:
-            result += 'q';
-            break;
-        }
-    }
+    uciOutput().send(text, engine_.outputPrefix());
+}
 
-    return result;
-}
\ No newline at end of file
+std::string UCIHandler::moveToString(const Move &move)
+{
+    // chess.hpp stores castling as king takes rook; this prints e1g1
+    return move == Move::NO_MOVE ? "0000" : chess::uci::moveToUci(move);
+}
@@ -6,6 +6,9 @@
 #include <sstream>
 #include "engine.h"
 
+// Hash size used by the perft command
+constexpr int PERFT_HASH_MB = 16;
+
 class UCIHandler {
 public:
     UCIHandler(ChessEngine& engine);
@@ -14,6 +17,7 @@ public:
     
 private:
     ChessEngine& engine_;
+    bool debug_ = false;
     
     // UCI command handlers
     void handleUCI();
@@ -26,10 +30,13 @@ private:
     void handleSetOption(std::istringstream& iss);
     void handlePerft(std::istringstream& iss);
     void handleEval();
+    void handleDebug(std::istringstream& iss);
     
     // Utility functions
+    void send(const std::string& text);  // Through uciOutput(), with the engine's prefix
     std::vector<std::string> split(const std::string& str, char delimiter);
     std::string moveToString(const Move& move);
+    static bool isMoveToken(const std::string& token);
 };
 
 #endif // UCI_H
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "uci_output.h"
+#include <cstdio>
+
+UCIOutput &UCIOutput::instance()
+{
+    static UCIOutput output;
+    return output;
+}
+
+UCIOutput::~UCIOutput()
+{
+    stop();
+}
+
+void UCIOutput::send(const std::string &text, const std::string &prefix)
+{
+    std::string lines;
+    size_t begin = 0;
+    do
+    {
+        size_t end = text.find('\n', begin);
+        lines += prefix;
+        lines.append(text, begin, end == std::string::npos ? std::string::npos : end - begin);
+        lines += '\n';
+        begin = end == std::string::npos ? text.size() : end + 1;
+    } while (begin < text.size());
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_)
+    {
+        write(lines);
+        return;
+    }
+
+    pending_ += lines;
+    lock.unlock();
+    cv_.notify_all();
+}
+
+void UCIOutput::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return pending_.empty() && !writing_; });
+}
+
+void UCIOutput::start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_)
+    {
+        return;
+    }
+    running_ = true;
+    stopping_ = false;
+    thread_ = std::thread(&UCIOutput::loop, this);
+}
+
+void UCIOutput::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_)
+        {
+            return;
+        }
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+}
+
+void UCIOutput::loop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true)
+    {
+        cv_.wait(lock, [this] { return !pending_.empty() || stopping_; });
+        if (pending_.empty())
+        {
+            return;
+        }
+
+        // Write unlocked so senders only ever wait for the swap
+        std::string batch;
+        batch.swap(pending_);
+        writing_ = true;
+        lock.unlock();
+        write(batch);
+        lock.lock();
+
+        writing_ = false;
+        cv_.notify_all();
+    }
+}
+
+void UCIOutput::write(const std::string &data)
+{
+    std::fwrite(data.data(), 1, data.size(), stdout);
+    std::fflush(stdout);
+}
@@ -0,0 +1,51 @@
+#ifndef UCI_OUTPUT_H
+#define UCI_OUTPUT_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Everything the engine tells the GUI goes through here. Once start() is
+// called, lines are queued and a dedicated thread writes whatever has piled
+// up with one write, so a search thread never blocks on a slow pipe. Before
+// start() (bench, tools) lines are written straight away; either way they
+// share stdout's buffer with std::cout, so output order is kept.
+class UCIOutput {
+public:
+    static UCIOutput& instance();
+
+    ~UCIOutput();
+
+    UCIOutput(const UCIOutput&) = delete;
+    UCIOutput& operator=(const UCIOutput&) = delete;
+
+    // One or more complete lines; the final newline is added if missing.
+    // A prefix goes in front of every line (server session IDs).
+    void send(const std::string& text, const std::string& prefix = "");
+
+    // Blocks until everything sent so far has been written
+    void flush();
+
+    void start();
+    // Writes what is left; later lines are written synchronously again
+    void stop();
+
+private:
+    UCIOutput() = default;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::string pending_;
+    bool running_ = false;
+    bool stopping_ = false;
+    bool writing_ = false;
+    std::thread thread_;
+
+    void loop();
+    static void write(const std::string& data);
+};
+
+inline UCIOutput& uciOutput() { return UCIOutput::instance(); }
+
+#endif // UCI_OUTPUT_H
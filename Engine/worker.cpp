@@ -0,0 +1,63 @@
+#include "worker.h"
+
+WorkerThread::WorkerThread() : busy_(false), exit_(false)
+{
+    // Started last, once the state it reads is initialized
+    thread_ = std::thread(&WorkerThread::loop, this);
+}
+
+WorkerThread::~WorkerThread()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        exit_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+void WorkerThread::run(std::function<void()> job)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !busy_; });
+    job_ = std::move(job);
+    busy_ = true;
+    lock.unlock();
+    cv_.notify_all();
+}
+
+void WorkerThread::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !busy_; });
+}
+
+bool WorkerThread::busy()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return busy_;
+}
+
+void WorkerThread::loop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true)
+    {
+        cv_.wait(lock, [this] { return busy_ || exit_; });
+        if (exit_)
+        {
+            return;
+        }
+
+        // Run the job unlocked so wait()/busy() stay responsive
+        std::function<void()> job = std::move(job_);
+        lock.unlock();
+        job();
+        lock.lock();
+
+        busy_ = false;
+        cv_.notify_all();
+    }
+}
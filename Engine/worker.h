@@ -0,0 +1,39 @@
+#ifndef WORKER_H
+#define WORKER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// A long-lived thread that runs one job at a time. Jobs are handed over
+// through a condition variable, so starting a search costs a wake-up
+// instead of a thread creation.
+class WorkerThread {
+public:
+    WorkerThread();
+    ~WorkerThread();
+
+    WorkerThread(const WorkerThread&) = delete;
+    WorkerThread& operator=(const WorkerThread&) = delete;
+
+    // Waits for the previous job to finish, then starts this one
+    void run(std::function<void()> job);
+
+    // Blocks until the current job (if any) has finished
+    void wait();
+
+    bool busy();
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::function<void()> job_;
+    bool busy_;
+    bool exit_;
+    std::thread thread_;
+
+    void loop();
+};
+
+#endif // WORKER_H